@@ -0,0 +1,109 @@
+#include "AnimationLibrary.h"
+#include <algorithm>
+
+void AnimationLibrary::Init()
+{
+	glCreateBuffers(1, &ClipBufferID);
+	glCreateBuffers(1, &FrameBufferID);
+}
+
+void AnimationLibrary::Shutdown()
+{
+	glDeleteBuffers(1, &ClipBufferID);
+	glDeleteBuffers(1, &FrameBufferID);
+	ClipBufferID = FrameBufferID = 0;
+
+	m_Clips.clear();
+	m_Frames.clear();
+	m_ClipHulls.clear();
+	m_IsDirty = false;
+	m_TimeOrigin = 0.0;
+}
+
+unsigned AnimationLibrary::AddClip(const std::vector<AnimationFrame>& _frames, LoopMode _mode)
+{
+	AnimationClip clip;
+	clip.FirstFrame = (GLuint)m_Frames.size();
+	clip.FrameCount = (GLuint)glm::max<size_t>(_frames.size(), 1);
+	clip.Mode = _mode;
+
+	m_Frames.insert(m_Frames.end(), _frames.begin(), _frames.end());
+	if (_frames.empty())
+		m_Frames.push_back({});
+	clip.Duration = glm::max(m_Frames.back().EndTime, 0.001f);
+
+	m_Clips.push_back(clip);
+	m_ClipHulls.push_back(std::any_of(_frames.begin(), _frames.end(), [](const AnimationFrame& _frame) { return _frame.HullCount > 0; }));
+	m_IsDirty = true;
+	return (unsigned)m_Clips.size() - 1;
+}
+
+unsigned AnimationLibrary::AddClip(const std::vector<glm::vec4>& _frames, float _framesPerSecond, LoopMode _mode)
+{
+	std::vector<AnimationFrame> frames(_frames.size());
+	for (size_t i = 0; i < _frames.size(); i++)
+	{
+		frames[i].UVRect = _frames[i];
+		frames[i].EndTime = (i + 1) / _framesPerSecond;
+	}
+	return AddClip(frames, _mode);
+}
+
+unsigned AnimationLibrary::AddGridClip(unsigned _columns, unsigned _frameCount, float _framesPerSecond, LoopMode _mode, const glm::vec2& _uvScale)
+{
+	unsigned rows = (_frameCount + _columns - 1) / _columns;
+	float width = 1.0f / _columns;
+	float height = 1.0f / rows;
+
+	std::vector<glm::vec4> frames;
+	frames.reserve(_frameCount);
+	for (unsigned frame = 0; frame < _frameCount; frame++)
+	{
+		glm::vec4 rect = { (frame % _columns) * width, 1.0f - ((frame / _columns) + 1) * height, width, height };
+		frames.push_back(rect * glm::vec4(_uvScale, _uvScale));
+	}
+	return AddClip(frames, _framesPerSecond, _mode);
+}
+
+unsigned AnimationLibrary::AddSheetClip(const SpriteSheet& _sheet, unsigned _firstFrame, unsigned _frameCount, LoopMode _mode, const glm::vec2& _uvScale)
+{
+	std::vector<AnimationFrame> frames;
+	frames.reserve(_frameCount);
+	float time = 0.0f;
+	for (unsigned i = _firstFrame; i < _firstFrame + _frameCount && i < _sheet.GetFrameCount(); i++)
+	{
+		const SpriteFrame& source = _sheet.GetFrame(i);
+		time += source.Duration;
+
+		AnimationFrame frame;
+		frame.UVRect = source.UVRect * glm::vec4(_uvScale, _uvScale);
+		frame.Quad = source.Quad;
+		frame.EndTime = time;
+		frame.HullCount = source.HullCount;
+		std::copy(source.Hull, source.Hull + source.HullCount, frame.Hull);
+		frames.push_back(frame);
+	}
+	return AddClip(frames, _mode);
+}
+
+void AnimationLibrary::Flush(CommandBuffer& _commands)
+{
+	if (m_IsDirty)
+	{
+		_commands.BufferData(ClipBufferID, m_Clips.size() * sizeof(AnimationClip), m_Clips.data(), GL_STATIC_DRAW);
+		_commands.BufferData(FrameBufferID, m_Frames.size() * sizeof(AnimationFrame), m_Frames.data(), GL_STATIC_DRAW);
+		m_IsDirty = false;
+	}
+
+	_commands.BindBufferBase(GL_SHADER_STORAGE_BUFFER, ClipBinding, ClipBufferID);
+	_commands.BindBufferBase(GL_SHADER_STORAGE_BUFFER, FrameBinding, FrameBufferID);
+}
+
+bool AnimationLibrary::UpdateTimeOrigin(double _time)
+{
+	if (_time - m_TimeOrigin < TimeRebaseInterval)
+		return false;
+
+	m_TimeOrigin = glm::floor(_time / TimeRebaseInterval) * TimeRebaseInterval;
+	return true;
+}
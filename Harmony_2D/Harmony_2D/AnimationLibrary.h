@@ -0,0 +1,82 @@
+#pragma once
+#include "CommandBuffer.h"
+#include "SpriteSheet.h"
+#include <cstddef>
+
+enum class LoopMode : GLuint
+{
+	Loop,
+	Once,
+	PingPong
+};
+
+// std430, matches AnimationClip in sprite.vert and basic.vert
+struct AnimationClip
+{
+	GLuint FirstFrame = 0;
+	GLuint FrameCount = 1;
+	GLfloat Duration = 0.1f; // seconds, sum of the frame durations
+	LoopMode Mode = LoopMode::Loop;
+};
+
+// std430, matches AnimationFrame in sprite.vert and basic.vert
+struct AnimationFrame
+{
+	glm::vec4 UVRect{ 0.0f, 0.0f, 1.0f, 1.0f }; // x, y, width, height
+	glm::vec4 Quad{ 0.0f, 0.0f, 1.0f, 1.0f };   // trimmed rect inside the unit quad (see SpriteFrame)
+	GLfloat EndTime = 0.1f;                      // seconds from the start of the clip
+	GLuint HullCount = 0;                        // 0 draws Quad
+	glm::vec2 Hull[SpriteFrame::MaxHullVertices]{};
+	GLfloat Padding[2]{};                        // std430 rounds the struct up to its vec4 alignment
+};
+static_assert(offsetof(AnimationFrame, Hull) == 40, "AnimationFrame::Hull must match std430 hull");
+static_assert(sizeof(AnimationFrame) == 112, "AnimationFrame must match the std430 array stride");
+
+// Flipbook clips as frame rect tables in two storage buffers. Shaders pick the frame from the
+// global time and each sprite's start time and speed, so animation costs no CPU work or upload
+// per frame. Tables only change when a clip is added, Flush() then records the re-upload.
+//
+// Times stay double on the CPU. Shaders get them as floats relative to a time origin that moves
+// forward every TimeRebaseInterval seconds, like the camera's floating origin, so float precision
+// does not degrade however long the game runs.
+static class AnimationLibrary
+{
+public:
+	static void Init();
+	static void Shutdown();
+
+	static unsigned AddClip(const std::vector<AnimationFrame>& _frames, LoopMode _mode = LoopMode::Loop);
+	// _frames are UV rects (x, y, width, height), played at a fixed rate over the whole quad
+	static unsigned AddClip(const std::vector<glm::vec4>& _frames, float _framesPerSecond, LoopMode _mode = LoopMode::Loop);
+	// Frames run left to right, top to bottom over a _columns wide sheet, UVs scaled by _uvScale (see TextureLayer)
+	static unsigned AddGridClip(unsigned _columns, unsigned _frameCount, float _framesPerSecond, LoopMode _mode = LoopMode::Loop, const glm::vec2& _uvScale = { 1.0f, 1.0f });
+	// _frameCount frames of _sheet from _firstFrame, trimmed and timed by the sheet's descriptor
+	static unsigned AddSheetClip(const SpriteSheet& _sheet, unsigned _firstFrame, unsigned _frameCount, LoopMode _mode = LoopMode::Loop, const glm::vec2& _uvScale = { 1.0f, 1.0f });
+
+	// Records the table upload if a clip was added, then binds the tables
+	static void Flush(CommandBuffer& _commands);
+
+	// Moves the time origin once _time is TimeRebaseInterval past it, returns true when it moved.
+	// Shader times written against the old origin have to be written again.
+	static bool UpdateTimeOrigin(double _time);
+	inline static double GetTimeOrigin() { return m_TimeOrigin; }
+	inline static float ToShaderTime(double _time) { return (float)(_time - m_TimeOrigin); }
+
+	inline static size_t GetClipCount() { return m_Clips.size(); }
+	// Whether any frame of the clip has a hull, only those sprites pay for tight mesh vertices
+	inline static bool HasHull(unsigned _clip) { return _clip < m_ClipHulls.size() && m_ClipHulls[_clip]; }
+
+	static const GLuint ClipBinding = 7;
+	static const GLuint FrameBinding = 8;
+	inline static const double TimeRebaseInterval = 1024.0;
+
+private:
+	inline static GLuint ClipBufferID = 0;
+	inline static GLuint FrameBufferID = 0;
+
+	inline static std::vector<AnimationClip> m_Clips;
+	inline static std::vector<AnimationFrame> m_Frames;
+	inline static std::vector<unsigned char> m_ClipHulls;
+	inline static bool m_IsDirty = false;
+	inline static double m_TimeOrigin = 0.0;
+};
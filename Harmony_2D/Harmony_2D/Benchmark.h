@@ -0,0 +1,566 @@
+#pragma once
+#include "Camera.h"
+#include "TransformStore.h"
+#include "SceneHierarchy.h"
+#include "SpriteSystems.h"
+#include "Mesh.h"
+#include "RenderThread.h"
+#include <chrono>
+#include <random>
+
+static class Benchmark
+{
+public:
+	static const bool IsEnabled = false;
+
+	inline static void RunAll()
+	{
+		FloatingOriginStress();
+		TransformStoreUpdate();
+		HierarchyUpdate();
+		EntityThroughput();
+		JobScaling();
+		InstanceGeneration();
+		VertexFormats();
+		CullingThroughput();
+		GeometrySharing();
+		SheetTrimming();
+	}
+
+	// Flies the camera _distance units away from the origin and checks that a sprite parked
+	// next to it still lands on the same sub-pixel screen position as a double precision reference.
+	inline static bool FloatingOriginStress(double _distance = 10000000.0)
+	{
+		std::map<int, bool> keyMap;
+		keyMap[GLFW_KEY_D] = true;
+		keyMap[GLFW_KEY_SPACE] = true;
+
+		Camera camera(keyMap);
+		camera.Input();
+
+		const glm::dvec3 spriteOffset = { 123.456, -78.901, -2.0 };
+		const glm::vec4 spriteCorner = { 0.5f, 0.5f, 0.0f, 1.0f };
+		const glm::mat4 projection = camera.GetProjectionMatrix();
+		const double deltaTime = 1.0 / 60.0;
+
+		Transform transform;
+		transform.scale = { 16, 16, 1 };
+
+		double maxError = 0.0;
+		double maxNaiveError = 0.0;
+		unsigned frames = 0;
+		while (camera.GetPosition().x < _distance)
+		{
+			camera.Movement(deltaTime);
+			transform.translation = camera.GetPosition() + spriteOffset;
+
+			// Reference : exact world space offset from the camera, one unit per pixel
+			glm::dvec2 expected = glm::dvec2(spriteOffset) + glm::dvec2(spriteCorner) * glm::dvec2(transform.scale);
+
+			// Camera relative (floating origin)
+			glm::vec4 clip = projection * camera.GetViewMatrix() * UpdateModelValueOfTransform(transform, camera.GetOrigin()) * spriteCorner;
+			maxError = glm::max(maxError, ScreenError(clip, expected));
+
+			// Absolute float coordinates, for comparison
+			glm::vec3 cameraPosition = glm::vec3(camera.GetPosition());
+			glm::mat4 naiveView = glm::lookAt(cameraPosition, cameraPosition + glm::vec3(0, 0, -1), glm::vec3(0, 1, 0));
+			clip = projection * naiveView * UpdateModelValueOfTransform(transform) * spriteCorner;
+			maxNaiveError = glm::max(maxNaiveError, ScreenError(clip, expected));
+
+			frames++;
+		}
+
+		bool passed = maxError < 0.01;
+		Print("Floating Origin Stress : " + std::to_string(frames) + " frames, " + std::to_string(camera.GetPosition().x) + " units");
+		Print("  Max Error (Rebased) : " + std::to_string(maxError) + "px");
+		Print("  Max Error (Absolute) : " + std::to_string(maxNaiveError) + "px");
+		Print(passed ? "  PASSED" : "  FAILED");
+		return passed;
+	}
+
+	// Times the SIMD affine kernel over _count SoA transforms against the scalar fallback
+	inline static double TransformStoreUpdate(size_t _count = 1000000, unsigned _iterations = 20)
+	{
+		TransformStore store;
+		store.Reserve(_count);
+
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-10000.0f, 10000.0f);
+		std::uniform_real_distribution<float> angle(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> scale(0.5f, 64.0f);
+		for (size_t i = 0; i < _count; i++)
+		{
+			store.Add(position(random), position(random), angle(random), scale(random), scale(random));
+		}
+
+		// Warm Up
+		store.Update();
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < _iterations; i++)
+		{
+			store.Update();
+		}
+		double simdTime = ElapsedMilliseconds(start) / _iterations;
+
+		TransformStore reference = store;
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < _iterations; i++)
+		{
+			reference.UpdateScalar(0, reference.Size());
+		}
+		double scalarTime = ElapsedMilliseconds(start) / _iterations;
+
+		float maxError = 0.0f;
+		for (size_t i = 0; i < _count; i++)
+		{
+			maxError = glm::max(maxError, glm::abs(store.m_A[i] - reference.m_A[i]) / store.m_ScaleX[i]);
+			maxError = glm::max(maxError, glm::abs(store.m_B[i] - reference.m_B[i]) / store.m_ScaleX[i]);
+		}
+
+		Print("Transform Store Update : " + std::to_string(_count) + " transforms");
+		Print("  SIMD : " + std::to_string(simdTime) + "ms");
+		Print("  Scalar : " + std::to_string(scalarTime) + "ms");
+		Print("  Max Error : " + std::to_string(maxError));
+		return simdTime;
+	}
+
+	// _characters root entities with _attachments attached entities each; moves _movedPerFrame roots per
+	// frame and reports how many world transforms the lazy propagation actually recomputed
+	inline static void HierarchyUpdate(unsigned _characters = 10000, unsigned _attachments = 9, unsigned _movedPerFrame = 100, unsigned _frames = 60)
+	{
+		EntityRegistry registry;
+		registry.Reserve(_characters * (_attachments + 2));
+
+		// Characters are anchors, each attachment chain hangs off a root node of its own.
+		// Attachments go in after all the characters, so the depth first arrays are built by one sort.
+		std::vector<unsigned> roots;
+		std::vector<Entity> characters;
+		for (unsigned i = 0; i < _characters; i++)
+		{
+			Entity character = registry.Create();
+			registry.m_Transforms.Add(character.Index, (double)i * 200.0, 0.0, 0.0f, 184.0f, 325.0f);
+			characters.push_back(character);
+
+			Entity root = registry.Create();
+			registry.m_Transforms.Add(root.Index, 0.0, 0.0);
+			roots.push_back(registry.m_Hierarchy.AddNode({ 1, 0, 0, 1, 0, 0 }));
+			registry.m_HierarchyNodes.Add(root.Index, { roots.back(), character });
+		}
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < _characters; i++)
+		{
+			for (unsigned j = 0; j < _attachments; j++)
+			{
+				Entity attachment = registry.Create();
+				registry.m_Transforms.Add(attachment.Index, 0.0, 0.0);
+				registry.m_HierarchyNodes.Add(attachment.Index, { registry.m_Hierarchy.AddNode({ 1, 0, 0, 1, (float)j, 1 }, roots[i]), characters[i] });
+			}
+		}
+		double buildTime = ElapsedMilliseconds(start);
+
+		SpriteSystems::UpdateTransforms(registry);
+		start = std::chrono::high_resolution_clock::now();
+		SpriteSystems::UpdateHierarchy(registry);
+		const SceneHierarchy& hierarchy = registry.m_Hierarchy;
+		Print("Hierarchy Update : " + std::to_string(hierarchy.Size()) + " nodes, " + std::to_string(buildTime) + "ms to attach, first pass recomputed "
+			+ std::to_string(hierarchy.GetStats().Recomputed) + " in " + std::to_string(ElapsedMilliseconds(start)) + "ms");
+
+		// Static Frame
+		start = std::chrono::high_resolution_clock::now();
+		SpriteSystems::UpdateHierarchy(registry);
+		Print("  Static Frame : " + std::to_string(hierarchy.GetStats().Recomputed) + " recomputed, " + std::to_string(ElapsedMilliseconds(start)) + "ms");
+
+		// Moving Frames
+		unsigned recomputed = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned frame = 0; frame < _frames; frame++)
+		{
+			for (unsigned i = 0; i < _movedPerFrame; i++)
+			{
+				unsigned root = roots[(frame * _movedPerFrame + i) % roots.size()];
+				Affine2D local = registry.m_Hierarchy.GetLocal(root);
+				local.ty += 1.0f;
+				registry.m_Hierarchy.SetLocal(root, local);
+			}
+			SpriteSystems::UpdateHierarchy(registry);
+			recomputed += hierarchy.GetStats().Recomputed;
+		}
+		Print("  Moving Frame : " + std::to_string(recomputed / _frames) + " recomputed, " + std::to_string(ElapsedMilliseconds(start) / _frames) + "ms");
+	}
+
+	// Memory per entity and per-system iteration cost of the packed pools
+	inline static void EntityThroughput(unsigned _count = 1000000)
+	{
+		EntityRegistry registry;
+		registry.Reserve(_count);
+
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-20000.0f, 20000.0f);
+		for (unsigned i = 0; i < _count; i++)
+		{
+			Entity entity = registry.Create();
+			registry.m_Transforms.Add(entity.Index, position(random), position(random), 0.0f, 184.0f, 325.0f);
+			registry.m_Sprites.Add(entity.Index, { 1 });
+			registry.m_Animations.Add(entity.Index, { 0, (float)(i % 8) / 10.0f });
+			registry.m_PickIDs.Add(entity.Index, { (int)i });
+		}
+
+		// One Mesh per sprite: the object, its four vertices, six indices and texture record
+		size_t meshBytes = sizeof(Mesh) + 4 * sizeof(Vertex) + 6 * sizeof(unsigned) + sizeof(Texture);
+
+		Print("Entity Throughput : " + std::to_string(registry.Count()) + " entities");
+		Print("  Memory Per Entity : " + std::to_string((double)registry.MemoryUsage() / _count) + " bytes (Mesh : " + std::to_string(meshBytes) + " bytes + GL objects)");
+
+		auto start = std::chrono::high_resolution_clock::now();
+		SpriteSystems::UpdateTransforms(registry);
+		Print("  Update Transforms : " + std::to_string(ElapsedMilliseconds(start)) + "ms");
+
+		FrameList<unsigned> visible = FrameAllocator::AllocateList<unsigned>(_count);
+		start = std::chrono::high_resolution_clock::now();
+		SpriteSystems::Cull(registry, { -540.0f, -540.0f, 540.0f, 540.0f }, visible);
+		Print("  Cull : " + std::to_string(ElapsedMilliseconds(start)) + "ms, " + std::to_string(visible.size()) + " visible");
+	}
+
+	// Per stage speedup of the job system ports against worker count
+	inline static void JobScaling(unsigned _count = 1000000, unsigned _iterations = 10)
+	{
+		EntityRegistry registry;
+		registry.Reserve(_count);
+
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-20000.0f, 20000.0f);
+		for (unsigned i = 0; i < _count; i++)
+		{
+			Entity entity = registry.Create();
+			registry.m_Transforms.Add(entity.Index, position(random), position(random), (float)i, 184.0f, 325.0f);
+			registry.m_Sprites.Add(entity.Index, { 1 });
+			registry.m_PickIDs.Add(entity.Index, { (int)i });
+		}
+
+		// Whole world in view so instance generation sees every sprite
+		const glm::vec4 viewRect = { -30000.0f, -30000.0f, 30000.0f, 30000.0f };
+		std::vector<SpriteInstance> instances(_count);
+
+		Print("Job Scaling : " + std::to_string(_count) + " sprites, " + std::to_string(std::thread::hardware_concurrency()) + " hardware threads");
+		double baseline[3] = {};
+		for (unsigned workers = 1; workers <= 16; workers *= 2)
+		{
+			JobSystem::Init(workers);
+
+			double times[3] = {};
+			for (unsigned i = 0; i < _iterations; i++)
+			{
+				FrameAllocator::Reset();
+				FrameList<unsigned> visible = FrameAllocator::AllocateList<unsigned>(_count);
+
+				auto start = std::chrono::high_resolution_clock::now();
+				SpriteSystems::UpdateTransforms(registry);
+				times[0] += ElapsedMilliseconds(start) / _iterations;
+
+				start = std::chrono::high_resolution_clock::now();
+				SpriteSystems::Cull(registry, viewRect, visible);
+				times[1] += ElapsedMilliseconds(start) / _iterations;
+
+				start = std::chrono::high_resolution_clock::now();
+				SpriteSystems::GenerateInstances(registry, visible, instances.data());
+				times[2] += ElapsedMilliseconds(start) / _iterations;
+			}
+
+			if (workers == 1)
+			{
+				for (int i = 0; i < 3; i++)
+					baseline[i] = times[i];
+			}
+
+			Print(FrameAllocator::Format("  %2u Workers : Transforms %.2fms (x%.2f) | Cull %.2fms (x%.2f) | Instances %.2fms (x%.2f)",
+				workers, times[0], baseline[0] / times[0], times[1], baseline[1] / times[1], times[2], baseline[2] / times[2]));
+		}
+
+		JobSystem::Init();
+		FrameAllocator::Reset();
+	}
+
+	// Parallel instance generation for _count dynamic sprites against a serial pass, checked instance
+	// for instance. Also decodes every corner the way sprite.vert does and reports the largest error
+	// against the float matrix. Budget is one 60 Hz frame.
+	inline static double InstanceGeneration(unsigned _count = 500000, unsigned _iterations = 10)
+	{
+		EntityRegistry registry;
+		registry.Reserve(_count);
+
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-20000.0f, 20000.0f);
+		for (unsigned i = 0; i < _count; i++)
+		{
+			Entity entity = registry.Create();
+			registry.m_Transforms.Add(entity.Index, position(random), position(random), (float)i, 184.0f, 325.0f);
+			registry.m_Sprites.Add(entity.Index, { 1, { (i % 8) / 8.0f, 0.0f, 0.125f, 1.0f } });
+			registry.m_PickIDs.Add(entity.Index, { (int)i });
+		}
+		SpriteSystems::UpdateTransforms(registry);
+
+		FrameList<unsigned> visible = FrameAllocator::AllocateList<unsigned>(_count);
+		for (unsigned i = 0; i < _count; i++)
+			visible.push_back(i);
+
+		std::vector<SpriteInstance> instances(_count);
+		auto start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < _iterations; i++)
+		{
+			SpriteSystems::GenerateInstances(registry, visible, instances.data());
+		}
+		double parallelTime = ElapsedMilliseconds(start) / _iterations;
+
+		// Serial Reference
+		const TransformStore& store = registry.m_Transforms.m_Store;
+		std::vector<SpriteInstance> reference(_count);
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < _count; i++)
+		{
+			const SpriteComponent& sprite = registry.m_Sprites.m_Data[i];
+			SpriteBatch::WriteInstance(reference.data() + i, store.GetMatrix(i), store.m_Layer[i], sprite.UVRect * glm::vec4(sprite.UVScale, sprite.UVScale), sprite.Color, registry.m_PickIDs.m_Data[i].ID, sprite.TextureLayer);
+		}
+		double serialTime = ElapsedMilliseconds(start);
+		bool matches = std::memcmp(instances.data(), reference.data(), instances.size() * sizeof(SpriteInstance)) == 0;
+
+		// Corner Error Against The Float Matrix
+		const glm::vec2 corners[4] = { {-0.5f, 0.5f}, {-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f} };
+		float maxError = 0.0f;
+		for (unsigned i = 0; i < _count; i++)
+		{
+			Affine2D matrix = store.GetMatrix(i);
+			glm::mat2 basis = { instances[i].a, instances[i].b, instances[i].c, instances[i].d };
+			for (const glm::vec2& corner : corners)
+			{
+				glm::vec2 exact = { matrix.a * corner.x + matrix.c * corner.y, matrix.b * corner.x + matrix.d * corner.y };
+				maxError = glm::max(maxError, glm::length(basis * corner - exact));
+			}
+		}
+
+		Print(FrameAllocator::Format("Instance Generation : %u sprites, %u workers", _count, JobSystem::GetWorkerCount()));
+		Print(FrameAllocator::Format("  Parallel : %.2fms | Serial : %.2fms | Frame Budget 16.67ms | %s | Max Corner Error %.4fpx",
+			parallelTime, serialTime, matches ? "Instances Match" : "INSTANCES DIFFER", maxError));
+		return parallelTime;
+	}
+
+	// Bytes each sprite costs per frame in each layout, and the streaming cost of _sprites sprites at 60 Hz.
+	// Vertex layouts also pay for 6 indices per quad, vertex pulling needs neither vertices nor indices.
+	inline static void VertexFormats(unsigned _sprites = 500000)
+	{
+		// Previous sprite vertex : vec3 position, vec2 UVs, int ID
+		const size_t indices = 6 * sizeof(unsigned);
+		const size_t floatSprite = 4 * (3 * sizeof(float) + 2 * sizeof(float) + sizeof(GLint)) + indices;
+		// Previous packed vertex : snorm16x2, unorm16x2, unorm8x4, uint
+		const size_t packedSprite = 4 * 16 + indices;
+		const size_t instanceSprite = sizeof(SpriteInstance);
+
+		auto report = [_sprites](const char* _name, size_t _bytes, size_t _baseline)
+		{
+			Print(FrameAllocator::Format("  %s : %zu bytes per sprite, %.1f MB per frame, %.2f GB/s (x%.2f smaller)", _name, _bytes,
+				_bytes * (double)_sprites / 1048576.0, _bytes * (double)_sprites * 60.0 / 1073741824.0, (double)_baseline / _bytes));
+		};
+
+		Print("Vertex Formats : " + std::to_string(_sprites) + " sprites per frame");
+		Print(FrameAllocator::Format("  Mesh Vertex : %zu bytes", (size_t)Mesh::GetVertexLayout().GetStride()));
+		report("Float Vertices", floatSprite, floatSprite);
+		report("Packed Vertices", packedSprite, floatSprite);
+		report("Pulled Instance", instanceSprite, floatSprite);
+	}
+
+	// Draws _count sprites spread far past the view with CPU culling, then with GPU culling, and reports
+	// the CPU time to cull and record a frame against the whole frame once the GPU has finished.
+	// Needs the GL context on this thread.
+	inline static void CullingThroughput(unsigned _count = 500000, unsigned _frames = 60)
+	{
+		std::map<int, bool> keyMap;
+		Camera camera(keyMap);
+		SpriteBatch batch(camera, _count);
+		CommandBuffer commands;
+
+		TextureLayer texture = TextureLoader::LoadTextureLayer("Resources/Textures/Capguy_Walk.png");
+		EntityRegistry registry;
+		registry.Reserve(_count);
+
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-20000.0f, 20000.0f);
+		for (unsigned i = 0; i < _count; i++)
+		{
+			Entity entity = registry.Create();
+			registry.m_Transforms.Add(entity.Index, position(random), position(random), (float)i, 184.0f, 325.0f);
+			registry.m_Sprites.Add(entity.Index, { texture.ArrayID, { 0.0f, 0.0f, 0.125f, 1.0f }, 0xFFFFFFFF, texture.Layer, texture.UVScale });
+			registry.m_PickIDs.Add(entity.Index, { (int)i });
+		}
+		SpriteSystems::UpdateTransforms(registry);
+
+		Print(FrameAllocator::Format("Culling Throughput : %u sprites", _count));
+		for (bool gpuCulling : { false, true })
+		{
+			batch.SetGPUCulling(gpuCulling);
+
+			double cpuTime = 0.0;
+			double frameTime = 0.0;
+			for (unsigned i = 0; i < _frames; i++)
+			{
+				FrameAllocator::Reset();
+				FrameList<unsigned> visible = FrameAllocator::AllocateList<unsigned>(_count);
+
+				auto start = std::chrono::high_resolution_clock::now();
+				if (!gpuCulling)
+					SpriteSystems::Cull(registry, camera.GetViewRect(), visible);
+				commands.Reset();
+				SpriteSystems::Render(registry, visible, batch, commands);
+				cpuTime += ElapsedMilliseconds(start) / _frames;
+
+				commands.Execute();
+				glFinish();
+				frameTime += ElapsedMilliseconds(start) / _frames;
+			}
+
+			Print(FrameAllocator::Format("  %s Culling : CPU %.2fms | Frame %.2fms | %u draw calls | %u texture binds",
+				gpuCulling ? "GPU" : "CPU", cpuTime, frameTime, batch.GetDrawCalls(), batch.GetTextureBinds()));
+		}
+		FrameAllocator::Reset();
+	}
+
+	// Registers the unit quad once per object for a _count object scene, as every Mesh used to
+	// build its own, plus the full screen quad. Reports the GL objects and bytes one VAO / VBO / IBO
+	// per object would take against the shared registry. Needs the GL context on this thread.
+	inline static void GeometrySharing(unsigned _count = 100000)
+	{
+		std::vector<unsigned> indices = { 0, 1, 2, 0, 2, 3 };
+		std::vector<Vertex> quad = {
+			{ {-0.5f, 0.5f, 0.0f}, {0.0f, 1.0f} }, { {-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f} },
+			{ {0.5f, -0.5f, 0.0f}, {1.0f, 0.0f} }, { {0.5f, 0.5f, 0.0f}, {1.0f, 1.0f} } };
+		std::vector<Vertex> screen = {
+			{ {-1.0f, 1.0f, 0.0f}, {0.0f, 1.0f} }, { {-1.0f, -1.0f, 0.0f}, {0.0f, 0.0f} },
+			{ {1.0f, -1.0f, 0.0f}, {1.0f, 0.0f} }, { {1.0f, 1.0f, 0.0f}, {1.0f, 1.0f} } };
+
+		GeometryStats before = GeometryRegistry::GetStats();
+		auto start = std::chrono::high_resolution_clock::now();
+		GeometryRegistry::Add(screen, indices);
+		for (unsigned i = 0; i < _count; i++)
+			GeometryRegistry::Add(quad, indices);
+		double time = ElapsedMilliseconds(start);
+		GeometryStats after = GeometryRegistry::GetStats();
+
+		unsigned requests = after.Requests - before.Requests;
+		Print(FrameAllocator::Format("Geometry Sharing : %u objects, %u unique meshes, registered in %.2fms", requests, after.Unique - before.Unique, time));
+		Print(FrameAllocator::Format("  Per Object : %u GL objects, %.1f KB", requests * 3, (after.UnsharedBytes - before.UnsharedBytes) / 1024.0));
+		Print(FrameAllocator::Format("  Registry : %u GL objects, %.1f KB used, %.1f KB reserved", after.VertexArrays + after.Buffers,
+			(after.UsedBytes - before.UsedBytes) / 1024.0, after.CapacityBytes / 1024.0));
+	}
+
+	// Slices _imagePath with the sheet tool and reports the pixels a sprite covers per frame as a
+	// quad, a trimmed quad and a hull, plus the cost of a frame lookup
+	inline static void SheetTrimming(const char* _imagePath = "Resources/Textures/Capguy_Walk.png", unsigned _columns = 8, unsigned _rows = 1, unsigned _lookups = 1000000)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		SpriteSheet sheet = SpriteSheet::Load(_imagePath, _columns, _rows, 0.1f);
+		double loadTime = ElapsedMilliseconds(start);
+		if (sheet.GetFrameCount() == 0)
+			return;
+
+		std::mt19937 random(1337);
+		std::uniform_int_distribution<unsigned> index(0, sheet.GetFrameCount() - 1);
+		float checksum = 0.0f;
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < _lookups; i++)
+			checksum += sheet.GetFrame(index(random)).Quad.z;
+		double lookupTime = ElapsedMilliseconds(start);
+
+		Print(FrameAllocator::Format("Sheet Trimming : %u frames loaded in %.2fms | %u lookups %.2fms (%g)", sheet.GetFrameCount(), loadTime, _lookups, lookupTime, checksum));
+		float quadTotal = 0.0f, trimmedTotal = 0.0f, hullTotal = 0.0f;
+		for (unsigned i = 0; i < sheet.GetFrameCount(); i++)
+		{
+			const SpriteFrame& frame = sheet.GetFrame(i);
+			float quad = (float)frame.SourceRect.z * frame.SourceRect.w;
+			float trimmed = (float)frame.TrimmedRect.z * frame.TrimmedRect.w;
+			float hull = sheet.GetCoveredPixels(i);
+			quadTotal += quad;
+			trimmedTotal += trimmed;
+			hullTotal += hull;
+			Print(FrameAllocator::Format("  Frame %u : quad %.0f px | trimmed %.0f px | hull %.0f px, %u vertices | %.1f%% fill saved",
+				i, quad, trimmed, hull, frame.HullCount, (1.0f - hull / quad) * 100.0f));
+		}
+		Print(FrameAllocator::Format("  Sheet : trimmed saves %.1f%%, hulls save %.1f%% of quad fill", (1.0f - trimmedTotal / quadTotal) * 100.0f, (1.0f - hullTotal / quadTotal) * 100.0f));
+	}
+
+	// Test scene : _count walkers playing _clip, each with its own start time and speed. Animation
+	// runs in sprite.vert, so beyond instance generation they cost no CPU and no upload per frame.
+	inline static void SpawnWalkers(EntityRegistry& _registry, const TextureLayer& _texture, unsigned _clip, const glm::vec2& _size, unsigned _count = 100000)
+	{
+		_registry.Reserve(_registry.Count() + _count);
+
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-5000.0f, 5000.0f);
+		std::uniform_real_distribution<float> phase(0.0f, 1.0f);
+		std::uniform_real_distribution<float> speed(0.5f, 1.5f);
+		double now = glfwGetTime();
+		for (unsigned i = 0; i < _count; i++)
+		{
+			Entity entity = _registry.Create();
+			_registry.m_Transforms.Add(entity.Index, position(random), position(random), 0.0f, _size.x, _size.y);
+			_registry.m_Sprites.Add(entity.Index, { _texture.ArrayID, { 0.0f, 0.0f, 1.0f, 1.0f }, 0xFFFFFFFF, _texture.Layer, _texture.UVScale });
+			_registry.m_Animations.Add(entity.Index, { _clip, now - phase(random), speed(random) });
+			_registry.m_PickIDs.Add(entity.Index, { (int)(i + 3) });
+		}
+
+		// Instance generation is the only per frame CPU work the walkers add
+		SpriteSystems::UpdateTransforms(_registry);
+		FrameList<unsigned> visible = FrameAllocator::AllocateList<unsigned>(_registry.m_Transforms.Size());
+		SpriteSystems::CollectAll(_registry, visible);
+		std::vector<SpriteInstance> instances(visible.size());
+
+		auto start = std::chrono::high_resolution_clock::now();
+		SpriteSystems::GenerateInstances(_registry, visible, instances.data());
+		Print(FrameAllocator::Format("Flipbook Walkers : %u spawned | Instances %.2fms | Animation 0ms, 0 bytes per frame", _count, ElapsedMilliseconds(start)));
+		FrameAllocator::Reset();
+	}
+
+	// Called once per frame from the main loop. Every _frames frames reports the average simulation,
+	// render and frame times and the bytes uploaded per frame; with the render thread the frame time drops below simulation + render
+	// by however much the two overlapped.
+	inline static void RenderThreadOverlap(size_t _uploadBytes, bool _isGPUCulling, unsigned _frames = 600)
+	{
+		static RenderThreadStats total;
+		static size_t uploadBytes = 0;
+		static unsigned frames = 0;
+
+		RenderThreadStats stats = RenderThread::GetStats();
+		total.Simulation += stats.Simulation;
+		total.Render += stats.Render;
+		total.Frame += stats.Frame;
+		uploadBytes += _uploadBytes;
+		if (++frames < _frames)
+			return;
+
+		double simulation = total.Simulation / frames;
+		double render = total.Render / frames;
+		double frame = total.Frame / frames;
+		double overlap = simulation + render - frame;
+		Print(FrameAllocator::Format("Render Thread (%s) : Simulation %.2fms | Render %.2fms | Frame %.2fms | Overlap %.2fms (%.0f%%)",
+			RenderThread::IsThreaded ? "Threaded" : "Inline", simulation, render, frame, overlap > 0.0 ? overlap : 0.0,
+			glm::clamp(100.0 * overlap / glm::min(simulation, render), 0.0, 100.0)));
+		Print(FrameAllocator::Format("  Upload : %.1f KB per frame | %s Culling", uploadBytes / 1024.0 / frames, _isGPUCulling ? "GPU" : "CPU"));
+
+		total = RenderThreadStats();
+		uploadBytes = 0;
+		frames = 0;
+	}
+
+private:
+	inline static double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& _start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - _start).count();
+	}
+
+	// Largest per-axis distance in pixels between a clip space point and the expected
+	// camera relative offset on the 1080x1080 target
+	inline static double ScreenError(const glm::vec4& _clip, const glm::dvec2& _expected)
+	{
+		glm::dvec2 pixel = glm::dvec2(_clip.x / _clip.w, _clip.y / _clip.w) * 540.0;
+		glm::dvec2 error = glm::abs(pixel - _expected);
+		return glm::max(error.x, error.y);
+	}
+};
@@ -1,6 +1,6 @@
 #include "Camera.h"
 
-Camera::Camera(std::map<int, bool>& _keyMap, glm::vec3 _position, glm::vec3 _up, glm::vec3 _front)
+Camera::Camera(std::map<int, bool>& _keyMap, glm::dvec3 _position, glm::vec3 _up, glm::vec3 _front)
 {
     m_KeyPresses = &_keyMap;
     m_Position = _position;
@@ -20,29 +20,42 @@ Camera::~Camera()
 
 void Camera::Movement(const long double& _dt)
 {
-    UpdatePosition(_dt);
+    if (UpdatePosition(_dt))
+        RebaseOrigin();
+}
+
+bool Camera::RebaseOrigin()
+{
+    glm::dvec3 offset = m_Position - m_Origin;
+    if (glm::abs(offset.x) < m_RebaseDistance && glm::abs(offset.y) < m_RebaseDistance)
+        return false;
+
+    // Snap to a grid so the origin only ever takes exactly representable values
+    m_Origin.x = glm::floor(m_Position.x / m_RebaseDistance) * m_RebaseDistance;
+    m_Origin.y = glm::floor(m_Position.y / m_RebaseDistance) * m_RebaseDistance;
+    return true;
 }
 
 bool Camera::UpdatePosition(const long double& _dt)
 {
     bool moved = false;
-    float x = m_InputVec.x * m_MoveSpeed * _dt;
-    float y = m_InputVec.y * m_MoveSpeed * _dt;
-    float z = m_InputVec.z * m_MoveSpeed * _dt;
+    double x = m_InputVec.x * m_MoveSpeed * (double)_dt;
+    double y = m_InputVec.y * m_MoveSpeed * (double)_dt;
+    double z = m_InputVec.z * m_MoveSpeed * (double)_dt;
 
-    if (x >= 0.000000001f || x <= -0.000000001f)
+    if (x >= 0.000000001 || x <= -0.000000001)
     {
-        m_Position += m_Right * x;
+        m_Position += glm::dvec3(m_Right) * x;
         moved = true;
     }
-    if (y >= 0.000000001f || y <= -0.000000001f)
+    if (y >= 0.000000001 || y <= -0.000000001)
     {
-        m_Position += m_Up * y;
+        m_Position += glm::dvec3(m_Up) * y;
         moved = true;
     }
-    if (z >= 0.000000001f || z <= -0.000000001f)
+    if (z >= 0.000000001 || z <= -0.000000001)
     {
-        m_Position += m_Front * z;
+        m_Position += glm::dvec3(m_Front) * z;
         moved = true;
     }
 
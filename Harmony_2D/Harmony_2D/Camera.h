@@ -4,27 +4,64 @@
 class Camera
 {
 public:
-    Camera(std::map<int, bool>& _keyMap, glm::vec3 position = glm::vec3(0.0f, 0.0f, 2), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3 front = glm::vec3(0.0f, 0.0f, -1.0f));
+    Camera(std::map<int, bool>& _keyMap, glm::dvec3 position = glm::dvec3(0.0, 0.0, 2.0), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3 front = glm::vec3(0.0f, 0.0f, -1.0f));
     ~Camera();
 
+    // View is built from the camera's offset to the floating origin so it stays in float range
     inline glm::mat4 GetViewMatrix()
     {
-        return glm::lookAt(m_Position, m_Position + m_Front, m_Up);
+        glm::vec3 relativePosition = GetSnappedPosition();
+        return glm::lookAt(relativePosition, relativePosition + m_Front, m_Up);
     }
     inline glm::mat4 GetProjectionMatrix()
     {
-        return m_IsPerspective ? glm::perspective(glm::radians(m_Zoom), 1080.0f / 1080.0f, 0.1f, 100.0f) : glm::ortho((float) - 1080 / 2, (float)1080 / 2, (float)-1080 / 2, (float)1080 / 2, 0.1f, 100.0f);
+        glm::vec2 half = m_ViewSize * 0.5f;
+        return m_IsPerspective ? glm::perspective(glm::radians(m_Zoom), m_ViewSize.x / m_ViewSize.y, 0.1f, 100.0f) : glm::ortho(-half.x, half.x, -half.y, half.y, 0.1f, 100.0f);
+    }
+
+    // World units across the view, independent of the resolution it is rendered at
+    inline void SetViewSize(const glm::vec2& _viewSize) { m_ViewSize = _viewSize; }
+    inline const glm::vec2& GetViewSize() { return m_ViewSize; }
+    // Keeps the view height and fits the width to _aspect (width / height), so the view matches the window
+    inline void SetAspect(float _aspect) { m_ViewSize.x = m_ViewSize.y * _aspect; }
+
+    // World units per render texel the view snaps to so pixel art does not shimmer, 0 to move freely
+    inline void SetTexelSnap(float _texelSize) { m_TexelSnap = _texelSize; }
+    inline glm::vec3 GetSnappedPosition()
+    {
+        if (m_TexelSnap <= 0.0f)
+            return GetRelativePosition();
+
+        // Snap the absolute position so the grid does not move when the origin is rebased
+        glm::dvec3 snapped = m_Position;
+        snapped.x = glm::round(snapped.x / m_TexelSnap) * m_TexelSnap;
+        snapped.y = glm::round(snapped.y / m_TexelSnap) * m_TexelSnap;
+        return glm::vec3(snapped - m_Origin);
     }
 
     void Input();
     void Movement(const long double& _dt);
     void ProcessMouse(const float& _xOffset, const float& _yOffset);
     void ProcessScroll(const float& _yoffset);
-    glm::vec3 GetPosition() { return m_Position; };
+    glm::dvec3 GetPosition() { return m_Position; };
+    inline const glm::dvec3& GetOrigin() { return m_Origin; }
+    inline glm::vec3 GetRelativePosition() { return glm::vec3(m_Position - m_Origin); }
+    bool RebaseOrigin();
+
+    // Visible area (min x, min y, max x, max y) relative to the floating origin, orthographic only
+    inline glm::vec4 GetViewRect()
+    {
+        glm::vec3 relativePosition = GetSnappedPosition();
+        glm::vec2 half = m_ViewSize * 0.5f;
+        return { relativePosition.x - half.x, relativePosition.y - half.y, relativePosition.x + half.x, relativePosition.y + half.y };
+    }
 private:
     void UpdateCameraVectors();
     bool UpdatePosition(const long double& _dt);
 
+    // Distance (world units) the camera may drift from the origin before it is rebased
+    double m_RebaseDistance = 4096.0;
+
     float m_Yaw = -90.0f;
     float m_Pitch = 0.0f;
     float m_MoveSpeed = 3.0f;
@@ -32,11 +69,14 @@ private:
     float m_Zoom = 45.0f;
 
     bool m_IsPerspective = false;
+    glm::vec2 m_ViewSize{ 1080.0f, 1080.0f };
+    float m_TexelSnap = 0.0f;
 
     std::map<int, bool>* m_KeyPresses = nullptr;
 
     glm::vec3 m_InputVec;
-    glm::vec3 m_Position;
+    glm::dvec3 m_Position;
+    glm::dvec3 m_Origin{ 0.0 };
     glm::vec3 m_Front;
     glm::vec3 m_Up;
     glm::vec3 m_WorldUp;
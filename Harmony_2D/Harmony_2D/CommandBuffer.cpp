@@ -0,0 +1,322 @@
+#include "CommandBuffer.h"
+#include <cstring>
+
+void CommandBuffer::Reset()
+{
+	m_Commands.clear();
+	m_Data.clear();
+}
+
+void CommandBuffer::Execute() const
+{
+	for (auto& item : m_Commands)
+	{
+		const void* payload = item.Size > 0 ? m_Data.data() + item.Offset : nullptr;
+		switch (item.Type)
+		{
+		case RenderCommandType::BindFrameBuffer:
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, item.Object);
+			break;
+		}
+		case RenderCommandType::Enable:
+		{
+			glEnable(item.Target);
+			break;
+		}
+		case RenderCommandType::Disable:
+		{
+			glDisable(item.Target);
+			break;
+		}
+		case RenderCommandType::Clear:
+		{
+			glClear((GLbitfield)item.Param);
+			break;
+		}
+		case RenderCommandType::UseProgram:
+		{
+			glUseProgram(item.Object);
+			break;
+		}
+		case RenderCommandType::BindVertexArray:
+		{
+			glBindVertexArray(item.Object);
+			break;
+		}
+		case RenderCommandType::BindTextureUnit:
+		{
+			glBindTextureUnit((GLuint)item.Param, item.Object);
+			break;
+		}
+		case RenderCommandType::BindBuffer:
+		{
+			glBindBuffer(item.Target, item.Object);
+			break;
+		}
+		case RenderCommandType::BindBufferBase:
+		{
+			glBindBufferBase(item.Target, (GLuint)item.Param, item.Object);
+			break;
+		}
+		case RenderCommandType::BufferData:
+		{
+			glNamedBufferData(item.Object, (GLsizeiptr)item.Param, payload, item.Target);
+			break;
+		}
+		case RenderCommandType::BufferSubData:
+		{
+			glNamedBufferSubData(item.Object, (GLintptr)item.Param, item.Size, payload);
+			break;
+		}
+		case RenderCommandType::Uniform1i:
+		{
+			glUniform1i(item.Location, (GLint)item.Param);
+			break;
+		}
+		case RenderCommandType::Uniform1f:
+		{
+			glUniform1f(item.Location, *(const GLfloat*)payload);
+			break;
+		}
+		case RenderCommandType::Uniform2f:
+		{
+			const GLfloat* value = (const GLfloat*)payload;
+			glUniform2f(item.Location, value[0], value[1]);
+			break;
+		}
+		case RenderCommandType::UniformMatrix4fv:
+		{
+			glUniformMatrix4fv(item.Location, 1, GL_FALSE, (const GLfloat*)payload);
+			break;
+		}
+		case RenderCommandType::DrawElements:
+		{
+			glDrawElements(item.Target, item.Size, GL_UNSIGNED_INT, (void*)(item.Param * sizeof(unsigned)));
+			break;
+		}
+		case RenderCommandType::DrawElementsBaseVertex:
+		{
+			glDrawElementsBaseVertex(item.Target, item.Size, GL_UNSIGNED_INT, (void*)(item.Param * sizeof(unsigned)), item.Location);
+			break;
+		}
+		case RenderCommandType::DrawArrays:
+		{
+			glDrawArrays(item.Target, (GLint)item.Param, item.Size);
+			break;
+		}
+		case RenderCommandType::MultiDrawArraysIndirect:
+		{
+			glMultiDrawArraysIndirect(item.Target, (const void*)item.Param, item.Size, 0);
+			break;
+		}
+		case RenderCommandType::Callback:
+		{
+			item.Function(payload);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+void CommandBuffer::BindFrameBuffer(GLuint _frameBuffer)
+{
+	RenderCommand command{ RenderCommandType::BindFrameBuffer };
+	command.Object = _frameBuffer;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Enable(GLenum _capability)
+{
+	RenderCommand command{ RenderCommandType::Enable };
+	command.Target = _capability;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Disable(GLenum _capability)
+{
+	RenderCommand command{ RenderCommandType::Disable };
+	command.Target = _capability;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Clear(GLbitfield _mask)
+{
+	RenderCommand command{ RenderCommandType::Clear };
+	command.Param = _mask;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::UseProgram(GLuint _program)
+{
+	RenderCommand command{ RenderCommandType::UseProgram };
+	command.Object = _program;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::BindVertexArray(GLuint _vertexArray)
+{
+	RenderCommand command{ RenderCommandType::BindVertexArray };
+	command.Object = _vertexArray;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::BindTextureUnit(GLuint _unit, GLuint _texture)
+{
+	RenderCommand command{ RenderCommandType::BindTextureUnit };
+	command.Object = _texture;
+	command.Param = _unit;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::BindBuffer(GLenum _target, GLuint _buffer)
+{
+	RenderCommand command{ RenderCommandType::BindBuffer };
+	command.Target = _target;
+	command.Object = _buffer;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::BindBufferBase(GLenum _target, GLuint _index, GLuint _buffer)
+{
+	RenderCommand command{ RenderCommandType::BindBufferBase };
+	command.Target = _target;
+	command.Object = _buffer;
+	command.Param = _index;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::BufferData(GLuint _buffer, size_t _size, const void* _data, GLenum _usage)
+{
+	RenderCommand command{ RenderCommandType::BufferData };
+	command.Object = _buffer;
+	command.Target = _usage;
+	command.Param = _size;
+	if (_data)
+	{
+		command.Offset = CopyPayload(_data, _size);
+		command.Size = (unsigned)_size;
+	}
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::BufferSubData(GLuint _buffer, size_t _offset, size_t _size, const void* _data)
+{
+	RenderCommand command{ RenderCommandType::BufferSubData };
+	command.Object = _buffer;
+	command.Param = _offset;
+	command.Offset = CopyPayload(_data, _size);
+	command.Size = (unsigned)_size;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Uniform1i(GLint _location, GLint _value)
+{
+	RenderCommand command{ RenderCommandType::Uniform1i };
+	command.Location = _location;
+	command.Param = (size_t)_value;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Uniform1f(GLint _location, GLfloat _value)
+{
+	RenderCommand command{ RenderCommandType::Uniform1f };
+	command.Location = _location;
+	command.Offset = CopyPayload(&_value, sizeof(GLfloat));
+	command.Size = sizeof(GLfloat);
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Uniform2f(GLint _location, const glm::vec2& _value)
+{
+	RenderCommand command{ RenderCommandType::Uniform2f };
+	command.Location = _location;
+	command.Offset = CopyPayload(glm::value_ptr(_value), sizeof(glm::vec2));
+	command.Size = sizeof(glm::vec2);
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::UniformMatrix4fv(GLint _location, const glm::mat4& _value)
+{
+	RenderCommand command{ RenderCommandType::UniformMatrix4fv };
+	command.Location = _location;
+	command.Offset = CopyPayload(glm::value_ptr(_value), sizeof(glm::mat4));
+	command.Size = sizeof(glm::mat4);
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::DrawElements(GLenum _mode, unsigned _count, size_t _firstIndex)
+{
+	RenderCommand command{ RenderCommandType::DrawElements };
+	command.Target = _mode;
+	command.Size = _count;
+	command.Param = _firstIndex;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::DrawElementsBaseVertex(GLenum _mode, unsigned _count, size_t _firstIndex, GLint _baseVertex)
+{
+	RenderCommand command{ RenderCommandType::DrawElementsBaseVertex };
+	command.Target = _mode;
+	command.Size = _count;
+	command.Param = _firstIndex;
+	command.Location = _baseVertex;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::DrawArrays(GLenum _mode, unsigned _first, unsigned _count)
+{
+	RenderCommand command{ RenderCommandType::DrawArrays };
+	command.Target = _mode;
+	command.Size = _count;
+	command.Param = _first;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::MultiDrawArraysIndirect(GLenum _mode, size_t _offset, unsigned _drawCount)
+{
+	RenderCommand command{ RenderCommandType::MultiDrawArraysIndirect };
+	command.Target = _mode;
+	command.Size = _drawCount;
+	command.Param = _offset;
+	m_Commands.push_back(command);
+}
+
+void CommandBuffer::Callback(void (*_function)(const void* _payload), const void* _payload, size_t _payloadSize)
+{
+	RenderCommand command{ RenderCommandType::Callback };
+	command.Function = _function;
+	if (_payload && _payloadSize > 0)
+	{
+		command.Offset = CopyPayload(_payload, _payloadSize);
+		command.Size = (unsigned)_payloadSize;
+	}
+	m_Commands.push_back(command);
+}
+
+void* CommandBuffer::CallbackPayload(void (*_function)(const void* _payload), size_t _payloadSize)
+{
+	RenderCommand command{ RenderCommandType::Callback };
+	command.Function = _function;
+	command.Offset = AllocatePayload(_payloadSize);
+	command.Size = (unsigned)_payloadSize;
+	m_Commands.push_back(command);
+	return m_Data.data() + command.Offset;
+}
+
+unsigned CommandBuffer::AllocatePayload(size_t _size)
+{
+	// Keep payloads 16 byte aligned for matrices and vertex data
+	size_t offset = (m_Data.size() + 15) & ~(size_t)15;
+	m_Data.resize(offset + _size);
+	return (unsigned)offset;
+}
+
+unsigned CommandBuffer::CopyPayload(const void* _data, size_t _size)
+{
+	unsigned offset = AllocatePayload(_size);
+	std::memcpy(m_Data.data() + offset, _data, _size);
+	return offset;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "Helper.h"
+
+enum class RenderCommandType : unsigned char
+{
+	BindFrameBuffer,
+	Enable,
+	Disable,
+	Clear,
+	UseProgram,
+	BindVertexArray,
+	BindTextureUnit,
+	BindBuffer,
+	BindBufferBase,
+	BufferData,
+	BufferSubData,
+	Uniform1i,
+	Uniform1f,
+	Uniform2f,
+	UniformMatrix4fv,
+	DrawElements,
+	DrawElementsBaseVertex,
+	DrawArrays,
+	MultiDrawArraysIndirect,
+	Callback
+};
+
+// Plain data command. Variable sized payloads (buffer contents, uniform values) live in the
+// owning CommandBuffer's data blob and are referenced by offset.
+struct RenderCommand
+{
+	RenderCommandType Type;
+	GLenum Target = 0;
+	GLuint Object = 0;
+	GLint Location = 0;
+	unsigned Offset = 0;
+	unsigned Size = 0;
+	size_t Param = 0;
+	void (*Function)(const void* _payload) = nullptr;
+};
+
+// Records GL work without touching GL, so simulation code can build a frame on any thread.
+// Execute() replays it on the thread that owns the context.
+class CommandBuffer
+{
+public:
+	void Reset();
+	void Execute() const;
+
+	void BindFrameBuffer(GLuint _frameBuffer);
+	void Enable(GLenum _capability);
+	void Disable(GLenum _capability);
+	void Clear(GLbitfield _mask);
+	void UseProgram(GLuint _program);
+	void BindVertexArray(GLuint _vertexArray);
+	void BindTextureUnit(GLuint _unit, GLuint _texture);
+	void BindBuffer(GLenum _target, GLuint _buffer);
+	void BindBufferBase(GLenum _target, GLuint _index, GLuint _buffer);
+	void BufferData(GLuint _buffer, size_t _size, const void* _data, GLenum _usage);
+	void BufferSubData(GLuint _buffer, size_t _offset, size_t _size, const void* _data);
+	void Uniform1i(GLint _location, GLint _value);
+	void Uniform1f(GLint _location, GLfloat _value);
+	void Uniform2f(GLint _location, const glm::vec2& _value);
+	void UniformMatrix4fv(GLint _location, const glm::mat4& _value);
+	void DrawElements(GLenum _mode, unsigned _count, size_t _firstIndex);
+	void DrawElementsBaseVertex(GLenum _mode, unsigned _count, size_t _firstIndex, GLint _baseVertex);
+	void DrawArrays(GLenum _mode, unsigned _first, unsigned _count);
+	// Reads _drawCount commands from the bound GL_DRAW_INDIRECT_BUFFER starting at byte _offset
+	void MultiDrawArraysIndirect(GLenum _mode, size_t _offset, unsigned _drawCount);
+	void Callback(void (*_function)(const void* _payload), const void* _payload = nullptr, size_t _payloadSize = 0);
+	// As Callback but returns the payload to fill in place (valid until the next record)
+	void* CallbackPayload(void (*_function)(const void* _payload), size_t _payloadSize);
+
+	// Reserves payload bytes in the blob, returns the offset (the pointer is only valid until the next record)
+	unsigned AllocatePayload(size_t _size);
+	inline unsigned char* GetPayload(unsigned _offset) { return m_Data.data() + _offset; }
+
+	inline size_t GetCommandCount() const { return m_Commands.size(); }
+	inline size_t GetPayloadBytes() const { return m_Data.size(); }
+
+private:
+	unsigned CopyPayload(const void* _data, size_t _size);
+
+	std::vector<RenderCommand> m_Commands;
+	std::vector<unsigned char> m_Data;
+};
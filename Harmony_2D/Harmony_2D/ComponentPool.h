@@ -0,0 +1,131 @@
+#pragma once
+#include "TransformStore.h"
+
+// Sparse set mapping entity indices to a packed dense range. Pools built on top of it keep
+// their data in the same dense order, so systems iterate components linearly.
+class SparseSet
+{
+public:
+	inline static const unsigned Invalid = 0xFFFFFFFF;
+
+	inline bool Contains(unsigned _entityIndex) const
+	{
+		return _entityIndex < m_Sparse.size() && m_Sparse[_entityIndex] != Invalid;
+	}
+
+	inline unsigned DenseIndex(unsigned _entityIndex) const
+	{
+		return m_Sparse[_entityIndex];
+	}
+
+	inline unsigned Insert(unsigned _entityIndex)
+	{
+		if (_entityIndex >= m_Sparse.size())
+			m_Sparse.resize(_entityIndex + 1, Invalid);
+
+		m_Sparse[_entityIndex] = (unsigned)m_Dense.size();
+		m_Dense.push_back(_entityIndex);
+		m_Version++;
+		return m_Sparse[_entityIndex];
+	}
+
+	// Swap-removes the entity, returns the dense slot that the last element was moved into
+	inline unsigned Remove(unsigned _entityIndex)
+	{
+		unsigned removed = m_Sparse[_entityIndex];
+		unsigned last = m_Dense.back();
+		m_Dense[removed] = last;
+		m_Sparse[last] = removed;
+		m_Dense.pop_back();
+		m_Sparse[_entityIndex] = Invalid;
+		m_Version++;
+		return removed;
+	}
+
+	inline void Reserve(size_t _entities)
+	{
+		m_Sparse.reserve(_entities);
+		m_Dense.reserve(_entities);
+	}
+
+	inline size_t Size() const { return m_Dense.size(); }
+	inline size_t MemoryUsage() const { return (m_Sparse.capacity() + m_Dense.capacity()) * sizeof(unsigned); }
+	// Bumped by every insert and removal, so caches of the dense order know when to rebuild
+	inline unsigned GetVersion() const { return m_Version; }
+
+	// Dense index -> entity index
+	std::vector<unsigned> m_Dense;
+
+private:
+	std::vector<unsigned> m_Sparse;
+	unsigned m_Version = 0;
+};
+
+template <typename T>
+class ComponentPool : public SparseSet
+{
+public:
+	inline T& Add(unsigned _entityIndex, const T& _component)
+	{
+		Insert(_entityIndex);
+		m_Data.push_back(_component);
+		return m_Data.back();
+	}
+
+	inline void Erase(unsigned _entityIndex)
+	{
+		unsigned slot = Remove(_entityIndex);
+		m_Data[slot] = m_Data.back();
+		m_Data.pop_back();
+	}
+
+	inline T& Get(unsigned _entityIndex) { return m_Data[DenseIndex(_entityIndex)]; }
+
+	inline void Reserve(size_t _entities)
+	{
+		SparseSet::Reserve(_entities);
+		m_Data.reserve(_entities);
+	}
+
+	inline size_t MemoryUsage() const { return SparseSet::MemoryUsage() + m_Data.capacity() * sizeof(T); }
+
+	std::vector<T> m_Data;
+};
+
+// Transforms keep the TransformStore SoA layout so the SIMD kernel runs straight over the pool
+class TransformPool : public SparseSet
+{
+public:
+	inline unsigned Add(unsigned _entityIndex, double _x, double _y, float _rotation = 0.0f, float _scaleX = 1.0f, float _scaleY = 1.0f, float _layer = 0.0f)
+	{
+		Insert(_entityIndex);
+		return m_Store.Add(_x, _y, _rotation, _scaleX, _scaleY, _layer);
+	}
+
+	inline void Erase(unsigned _entityIndex)
+	{
+		unsigned slot = Remove(_entityIndex);
+		for (auto* item : { &m_Store.m_WorldX, &m_Store.m_WorldY })
+		{
+			(*item)[slot] = item->back();
+			item->pop_back();
+		}
+		for (auto* item : { &m_Store.m_X, &m_Store.m_Y, &m_Store.m_Rotation, &m_Store.m_ScaleX, &m_Store.m_ScaleY, &m_Store.m_Layer,
+			&m_Store.m_A, &m_Store.m_B, &m_Store.m_C, &m_Store.m_D })
+		{
+			(*item)[slot] = item->back();
+			item->pop_back();
+		}
+		m_Store.MarkDirty(slot);
+	}
+
+	inline void Reserve(size_t _entities)
+	{
+		SparseSet::Reserve(_entities);
+		m_Store.Reserve(_entities);
+	}
+
+	inline size_t MemoryUsage() const { return SparseSet::MemoryUsage() + m_Store.m_X.capacity() * (sizeof(float) * 10 + sizeof(double) * 2); }
+
+	TransformStore m_Store;
+};
@@ -0,0 +1,97 @@
+#include "DynamicResolution.h"
+
+// Aim this far under the target so small spikes do not miss it
+static const double Headroom = 0.9;
+// Weight of a new GPU time in the smoothed time
+static const double Smoothing = 0.2;
+// Largest change of the scale per step and the smallest worth resizing for
+static const float MaxStep = 0.1f;
+static const float MinChange = 0.02f;
+
+void DynamicResolution::Init()
+{
+	glCreateQueries(GL_TIMESTAMP, QueryFrames * 2, QueryIDs);
+	FrameBuffer::SetRenderScale(m_Scale);
+}
+
+void DynamicResolution::Shutdown()
+{
+	glDeleteQueries(QueryFrames * 2, QueryIDs);
+}
+
+void DynamicResolution::SetEnabled(bool _enabled)
+{
+	m_IsEnabled = _enabled;
+	if (!m_IsEnabled)
+	{
+		m_Scale = MaxScale;
+		FrameBuffer::SetRenderScale(m_Scale);
+	}
+	m_SmoothedTime = 0.0;
+	m_FramesSinceChange = 0;
+}
+
+void DynamicResolution::BeginFrame(CommandBuffer& _commands)
+{
+	_commands.Callback(WriteBegin, nullptr, 0);
+}
+
+void DynamicResolution::EndFrame(CommandBuffer& _commands)
+{
+	_commands.Callback(WriteEnd, nullptr, 0);
+}
+
+void DynamicResolution::Update()
+{
+	// Pixel perfect mode keeps its fixed virtual size
+	if (!m_IsEnabled || FrameBuffer::IsPixelPerfect() || !m_HasNewTime.exchange(false))
+		return;
+
+	double time = m_LastTime.load();
+	m_SmoothedTime = m_SmoothedTime == 0.0 ? time : glm::mix(m_SmoothedTime, time, Smoothing);
+	if (++m_FramesSinceChange < SettleFrames || m_SmoothedTime <= 0.0)
+		return;
+
+	// GPU time follows the pixel count, so each axis scales by the root of the time ratio
+	float scale = m_Scale * (float)glm::sqrt(TargetFrameTime * Headroom / m_SmoothedTime);
+	scale = glm::clamp(scale, m_Scale * (1.0f - MaxStep), m_Scale * (1.0f + MaxStep));
+	scale = glm::clamp(scale, MinScale, MaxScale);
+	if (glm::abs(scale - m_Scale) < MinChange)
+		return;
+
+	m_Scale = scale;
+	FrameBuffer::SetRenderScale(m_Scale);
+	m_FramesSinceChange = 0;
+}
+
+void DynamicResolution::WriteBegin(const void*)
+{
+	// Collect Finished Frames
+	for (unsigned slot = 0; slot < QueryFrames; slot++)
+	{
+		if (!m_IsPending[slot])
+			continue;
+
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(QueryIDs[slot * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE)
+			continue;
+
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(QueryIDs[slot * 2], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(QueryIDs[slot * 2 + 1], GL_QUERY_RESULT, &end);
+		m_IsPending[slot] = false;
+		m_LastTime.store((double)(end - begin) / 1000000.0);
+		m_HasNewTime.store(true);
+	}
+
+	// A slot still pending after QueryFrames frames is dropped and reused
+	m_Slot = (m_Slot + 1) % QueryFrames;
+	glQueryCounter(QueryIDs[m_Slot * 2], GL_TIMESTAMP);
+}
+
+void DynamicResolution::WriteEnd(const void*)
+{
+	glQueryCounter(QueryIDs[m_Slot * 2 + 1], GL_TIMESTAMP);
+	m_IsPending[m_Slot] = true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "FrameBuffer.h"
+#include <atomic>
+
+// Picks the frame buffer's render size each frame so the GPU time of a frame tracks
+// TargetFrameTime. Timestamps around the frame are written on the render thread into a ring of
+// QueryFrames query pairs and only read once available, so measuring never stalls. Update()
+// runs the controller on the simulation thread and hands the new size to FrameBuffer, which
+// applies it from the next recorded pass.
+static class DynamicResolution
+{
+public:
+	static void Init();
+	static void Shutdown();
+
+	inline static bool IsEnabled() { return m_IsEnabled; }
+	// Disabling goes back to the full render size
+	static void SetEnabled(bool _enabled);
+
+	// Timestamps either side of everything the frame draws
+	static void BeginFrame(CommandBuffer& _commands);
+	static void EndFrame(CommandBuffer& _commands);
+
+	// Moves the render scale toward the target using the latest GPU time, call before recording.
+	// Does nothing while FrameBuffer is pixel perfect
+	static void Update();
+
+	// Smoothed GPU time of a frame in milliseconds
+	inline static double GetGPUTime() { return m_SmoothedTime; }
+	inline static float GetScale() { return m_Scale; }
+
+	inline static double TargetFrameTime = 1000.0 / 60.0;
+	inline static float MinScale = 0.5f;
+	inline static float MaxScale = 1.0f;
+
+	static const unsigned QueryFrames = 4;
+	// Frames to wait after a change so the measurements reflect the new size
+	static const unsigned SettleFrames = QueryFrames + 4;
+
+private:
+	static void WriteBegin(const void* _payload);
+	static void WriteEnd(const void* _payload);
+
+	inline static GLuint QueryIDs[QueryFrames * 2] = {};
+	inline static bool m_IsEnabled = true;
+
+	// Render Thread
+	inline static unsigned m_Slot = 0;
+	inline static bool m_IsPending[QueryFrames] = {};
+	inline static std::atomic<double> m_LastTime{ 0.0 };
+	inline static std::atomic<bool> m_HasNewTime{ false };
+
+	// Simulation Thread
+	inline static double m_SmoothedTime = 0.0;
+	inline static float m_Scale = 1.0f;
+	inline static unsigned m_FramesSinceChange = 0;
+};
@@ -0,0 +1,105 @@
+#include "EntityRegistry.h"
+
+Entity EntityRegistry::Create()
+{
+	if (!m_FreeIndices.empty())
+	{
+		unsigned index = m_FreeIndices.back();
+		m_FreeIndices.pop_back();
+		return { index, m_Generations[index] };
+	}
+
+	m_Generations.push_back(0);
+	return { (unsigned)m_Generations.size() - 1, 0 };
+}
+
+void EntityRegistry::Destroy(Entity _entity)
+{
+	if (!IsAlive(_entity))
+		return;
+
+	if (m_Transforms.Contains(_entity.Index))
+		m_Transforms.Erase(_entity.Index);
+	if (m_Sprites.Contains(_entity.Index))
+		m_Sprites.Erase(_entity.Index);
+	if (m_Animations.Contains(_entity.Index))
+		m_Animations.Erase(_entity.Index);
+	if (m_PickIDs.Contains(_entity.Index))
+		m_PickIDs.Erase(_entity.Index);
+	DetachHierarchy(_entity);
+
+	m_Generations[_entity.Index]++;
+	m_FreeIndices.push_back(_entity.Index);
+}
+
+void EntityRegistry::DetachHierarchy(Entity _entity)
+{
+	// Subtrees Going Away : The Entity's Own Node And The Nodes Anchored To It
+	std::vector<unsigned> roots;
+	if (m_HierarchyNodes.Contains(_entity.Index))
+		roots.push_back(m_HierarchyNodes.Get(_entity.Index).Node);
+	for (auto& item : m_HierarchyNodes.m_Data)
+	{
+		if (item.Anchor.Index == _entity.Index && item.Anchor.Generation == _entity.Generation)
+			roots.push_back(item.Node);
+	}
+	if (roots.empty())
+		return;
+
+	// Every Entity Placed Inside One Loses Its Node, Before Removal Frees The Handles
+	std::vector<unsigned> detached;
+	for (unsigned i = 0; i < m_HierarchyNodes.Size(); i++)
+	{
+		for (auto& root : roots)
+		{
+			if (m_Hierarchy.IsInSubtree(m_HierarchyNodes.m_Data[i].Node, root))
+			{
+				detached.push_back(m_HierarchyNodes.m_Dense[i]);
+				break;
+			}
+		}
+	}
+
+	// Only The Outermost Subtrees, Nested Ones Go With Them
+	std::vector<unsigned> outermost;
+	for (auto& root : roots)
+	{
+		bool isNested = false;
+		for (auto& other : roots)
+			isNested |= other != root && m_Hierarchy.IsInSubtree(root, other);
+		if (!isNested)
+			outermost.push_back(root);
+	}
+	for (auto& root : outermost)
+	{
+		m_Hierarchy.RemoveNode(root);
+	}
+	for (auto& item : detached)
+	{
+		m_HierarchyNodes.Erase(item);
+	}
+}
+
+bool EntityRegistry::IsAlive(Entity _entity) const
+{
+	return _entity.Index < m_Generations.size() && m_Generations[_entity.Index] == _entity.Generation;
+}
+
+void EntityRegistry::Reserve(size_t _entities)
+{
+	m_Generations.reserve(_entities);
+	m_Transforms.Reserve(_entities);
+	m_Sprites.Reserve(_entities);
+	m_Animations.Reserve(_entities);
+	m_PickIDs.Reserve(_entities);
+}
+
+size_t EntityRegistry::MemoryUsage() const
+{
+	return (m_Generations.capacity() + m_FreeIndices.capacity()) * sizeof(unsigned)
+		+ m_Transforms.MemoryUsage()
+		+ m_Sprites.MemoryUsage()
+		+ m_Animations.MemoryUsage()
+		+ m_PickIDs.MemoryUsage()
+		+ m_HierarchyNodes.MemoryUsage();
+}
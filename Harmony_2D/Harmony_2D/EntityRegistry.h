@@ -0,0 +1,74 @@
+#pragma once
+#include "ComponentPool.h"
+#include "SceneHierarchy.h"
+
+struct Entity
+{
+	unsigned Index = 0;
+	unsigned Generation = 0;
+};
+
+struct SpriteComponent
+{
+	GLuint TextureID = 0; // GL_TEXTURE_2D_ARRAY
+	glm::vec4 UVRect = { 0.0f, 0.0f, 1.0f, 1.0f }; // x, y, width, height
+	GLuint Color = 0xFFFFFFFF; // RGBA8, red in the low byte
+	GLuint TextureLayer = 0;
+	glm::vec2 UVScale = { 1.0f, 1.0f }; // image size over the array's layer size
+};
+
+// Played on the GPU, see AnimationLibrary
+struct AnimationComponent
+{
+	unsigned Clip = 0;
+	double StartTime = 0.0; // glfwGetTime seconds
+	float Speed = 1.0f;
+};
+
+struct PickIDComponent
+{
+	int ID = -1;
+};
+
+// Places the entity at a SceneHierarchy node, relative to the transform of the anchor entity.
+// Anchors are ordinary transforms, so whole attachment chains ride the floating origin with them.
+struct HierarchyComponent
+{
+	unsigned Node = 0;
+	Entity Anchor;
+};
+
+// Owns the entity handles and one packed pool per component type.
+// Handles carry a generation so stale handles to a recycled index are rejected.
+class EntityRegistry
+{
+public:
+	Entity Create();
+	// Destroying an entity drops its hierarchy node and every node below it, and the nodes of entities
+	// anchored to it. Entities placed at any of those nodes lose their HierarchyComponent
+	void Destroy(Entity _entity);
+	bool IsAlive(Entity _entity) const;
+
+	void Reserve(size_t _entities);
+	size_t MemoryUsage() const;
+	inline size_t Count() const { return m_Generations.size() - m_FreeIndices.size(); }
+	// Changes whenever a pool the sprite instances are built from gains or loses an entity.
+	// Changing a sprite, animation or pick ID in place needs m_Transforms.m_Store.MarkDirty on its transform.
+	inline unsigned GetSpriteLayoutVersion() const
+	{
+		return m_Transforms.GetVersion() + m_Sprites.GetVersion() + m_Animations.GetVersion() + m_PickIDs.GetVersion();
+	}
+
+	TransformPool m_Transforms;
+	ComponentPool<SpriteComponent> m_Sprites;
+	ComponentPool<AnimationComponent> m_Animations;
+	ComponentPool<PickIDComponent> m_PickIDs;
+	ComponentPool<HierarchyComponent> m_HierarchyNodes;
+	SceneHierarchy m_Hierarchy;
+
+private:
+	void DetachHierarchy(Entity _entity);
+
+	std::vector<unsigned> m_Generations;
+	std::vector<unsigned> m_FreeIndices;
+};
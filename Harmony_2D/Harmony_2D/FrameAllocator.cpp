@@ -0,0 +1,32 @@
+#include "FrameAllocator.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef _DEBUG
+// Counting replacements for the global allocation functions, used by the zero allocation frame check in Main.cpp
+void* operator new(size_t _size)
+{
+	FrameAllocator::m_Allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(_size ? _size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t _size)
+{
+	FrameAllocator::m_Allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(_size ? _size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* _memory) noexcept
+{
+	std::free(_memory);
+}
+
+void operator delete[](void* _memory) noexcept
+{
+	std::free(_memory);
+}
+#endif
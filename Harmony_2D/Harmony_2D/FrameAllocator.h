@@ -0,0 +1,146 @@
+#pragma once
+#include "Helper.h"
+#include <atomic>
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+// Fixed capacity list whose storage lives in the frame arena, valid until the next Reset()
+template <typename T>
+struct FrameList
+{
+	T* Data = nullptr;
+	unsigned Size = 0;
+	unsigned Capacity = 0;
+
+	inline void push_back(const T& _value)
+	{
+		assert(Size < Capacity);
+		if (Size < Capacity)
+			Data[Size++] = _value;
+	}
+	inline void clear() { Size = 0; }
+	inline bool empty() const { return Size == 0; }
+	inline unsigned size() const { return Size; }
+	inline T& operator[](unsigned _index) { return Data[_index]; }
+	inline const T& operator[](unsigned _index) const { return Data[_index]; }
+	inline T* begin() { return Data; }
+	inline T* end() { return Data + Size; }
+	inline const T* begin() const { return Data; }
+	inline const T* end() const { return Data + Size; }
+};
+
+// Linear bump allocator for transient per-frame data (render lists, debug strings).
+// Allocations are never freed individually; Reset() at the top of the frame releases everything.
+// Once the arena is full, allocations fall back to the heap until the next Reset, so callers never see nullptr.
+// Allocate is safe to call from several threads, Reset is not.
+static class FrameAllocator
+{
+public:
+	inline static void Init(size_t _capacity = 32 * 1024 * 1024)
+	{
+		m_Buffer.resize(_capacity);
+		m_Offset = 0;
+		m_HighWater = 0;
+	}
+
+	inline static void Reset()
+	{
+		m_Offset = 0;
+		for (auto& item : m_Overflow)
+		{
+			std::free(item);
+		}
+		m_Overflow.clear();
+		m_HasOverflowed = false;
+	}
+
+	inline static void* Allocate(size_t _bytes, size_t _alignment = alignof(std::max_align_t))
+	{
+		// Lock free bump so systems running in parallel can share the arena
+		size_t offset = m_Offset.load(std::memory_order_relaxed);
+		size_t start = 0;
+		do
+		{
+			start = (offset + _alignment - 1) & ~(_alignment - 1);
+			if (start + _bytes > m_Buffer.size())
+				return AllocateOverflow(_bytes, _alignment);
+		} while (!m_Offset.compare_exchange_weak(offset, start + _bytes, std::memory_order_relaxed));
+
+		size_t highWater = m_HighWater.load(std::memory_order_relaxed);
+		while (start + _bytes > highWater && !m_HighWater.compare_exchange_weak(highWater, start + _bytes, std::memory_order_relaxed))
+		{
+		}
+		return m_Buffer.data() + start;
+	}
+
+	template <typename T>
+	inline static T* Allocate(size_t _count)
+	{
+		return static_cast<T*>(Allocate(_count * sizeof(T), alignof(T)));
+	}
+
+	template <typename T>
+	inline static FrameList<T> AllocateList(size_t _capacity)
+	{
+		return { Allocate<T>(_capacity), 0, (unsigned)_capacity };
+	}
+
+	// printf style formatting into the arena
+	inline static std::string_view Format(const char* _format, ...)
+	{
+		va_list args;
+		va_start(args, _format);
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+		int length = std::vsnprintf(nullptr, 0, _format, argsCopy);
+		va_end(argsCopy);
+
+		char* text = length < 0 ? nullptr : Allocate<char>((size_t)length + 1);
+		if (text == nullptr)
+		{
+			va_end(args);
+			return {};
+		}
+		std::vsnprintf(text, (size_t)length + 1, _format, args);
+		va_end(args);
+		return { text, (size_t)length };
+	}
+
+	inline static size_t GetUsed() { return m_Offset; }
+	inline static size_t GetHighWater() { return m_HighWater; }
+
+	// Global operator new calls, only counted in debug builds (see FrameAllocator.cpp)
+	inline static size_t GetAllocationCount() { return m_Allocations.load(std::memory_order_relaxed); }
+	inline static std::atomic<size_t> m_Allocations{ 0 };
+
+private:
+	inline static void* AllocateOverflow(size_t _bytes, size_t _alignment)
+	{
+		// Counted like operator new so the zero allocation check reports the frame
+		m_Allocations.fetch_add(1, std::memory_order_relaxed);
+		if (!m_HasOverflowed.exchange(true))
+			Print("Frame Allocator Out Of Memory, falling back to the heap");
+
+		unsigned char* memory = static_cast<unsigned char*>(std::malloc(_bytes + _alignment));
+		if (memory == nullptr)
+			throw std::bad_alloc();
+		{
+			std::lock_guard<std::mutex> lock(m_OverflowMutex);
+			m_Overflow.push_back(memory);
+		}
+		return memory + (_alignment - (size_t)memory % _alignment);
+	}
+
+	inline static std::vector<unsigned char> m_Buffer;
+	inline static std::atomic<size_t> m_Offset{ 0 };
+	inline static std::atomic<size_t> m_HighWater{ 0 };
+
+	// Heap blocks handed out past the end of the arena, freed by Reset
+	inline static std::vector<void*> m_Overflow;
+	inline static std::mutex m_OverflowMutex;
+	inline static std::atomic<bool> m_HasOverflowed{ false };
+};
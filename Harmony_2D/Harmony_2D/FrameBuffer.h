@@ -1,9 +1,38 @@
 #pragma once
-#include "Helper.h"
+#include "FrameAllocator.h"
+#include "CommandBuffer.h"
+#include <atomic>
+#include <mutex>
+
+// Targets a frame buffer pass can render to. Shader outputs keep fixed locations (color 0,
+// ID 1), a pass without an attachment just leaves that draw buffer GL_NONE. World positions
+// are reconstructed from depth (see ReconstructPosition) rather than stored.
+//
+// Attachments follow the window size (GetMaxSize), each pass only renders into the bottom left
+// render size of them. The render size is a fraction of the window picked at runtime (see
+// DynamicResolution), the composite pass stretches that region over the window. In pixel perfect mode
+// the render size is fixed to GetVirtualSize and the composite upscales it by the largest whole
+// factor that fits the window, centred, with nearest filtering.
+enum class Attachment : unsigned
+{
+	None = 0,
+	Color = 1 << 0,
+	ID = 1 << 1,
+	Depth = 1 << 2
+};
+
+inline Attachment operator|(Attachment _a, Attachment _b) { return (Attachment)((unsigned)_a | (unsigned)_b); }
+inline bool HasAttachment(Attachment _set, Attachment _attachment) { return ((unsigned)_set & (unsigned)_attachment) != 0; }
+
 static class FrameBuffer
 {
 public:
-	inline static void InitFrameBufferDSA()
+	// Normal frames only need color and depth, the picking targets are drawn on frames with a pick
+	inline static const Attachment ColorPass = Attachment::Color | Attachment::Depth;
+	inline static const Attachment PickPass = ColorPass | Attachment::ID;
+
+	// Allocates _attachments up front, the rest on the first pass that uses them
+	inline static void InitFrameBufferDSA(Attachment _attachments = ColorPass)
 	{
 		BackgroundColor[0] = 0.1f;
 		BackgroundColor[1] = 0.1f;
@@ -11,31 +40,46 @@ public:
 		BackgroundColor[3] = 1.0f;
 
 		glCreateFramebuffers(1, &FrameBufferID);
+		AllocateAttachments(_attachments, m_WindowSize);
+	}
 
-		glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferTexture);
-		glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferIDTexture);
-		glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferHitPosTexture);
-		glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferDepthTexture);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// Creates whichever of _attachments do not exist yet and resizes the existing ones to _size
+	inline static void AllocateAttachments(Attachment _attachments, const glm::ivec2& _size)
+	{
+		if (_size != m_AttachmentSize)
+		{
+			m_AttachmentSize = _size;
+			m_AttachmentBytes = 0;
+			ResizeAttachment(FrameBufferTexture, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+			ResizeAttachment(FrameBufferIDTexture, GL_R32I, GL_RED_INTEGER, GL_INT);
+			ResizeAttachment(FrameBufferDepthTexture, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT);
+		}
 
-		glTextureStorage2D(FrameBufferTexture, 1, GL_RGBA8, 1080, 1080);
-		glNamedFramebufferTexture(FrameBufferID, GL_COLOR_ATTACHMENT0, FrameBufferTexture, 0);
+		if (HasAttachment(_attachments, Attachment::Color) && FrameBufferTexture == 0)
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferTexture);
+			glTextureParameteri(FrameBufferTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(FrameBufferTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(FrameBufferTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(FrameBufferTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			ResizeAttachment(FrameBufferTexture, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+			glNamedFramebufferTexture(FrameBufferID, GL_COLOR_ATTACHMENT0, FrameBufferTexture, 0);
+		}
 
 		// ID's
-		glTextureStorage2D(FrameBufferIDTexture, 1, GL_R32I, 1080, 1080);
-		glNamedFramebufferTexture(FrameBufferID, GL_COLOR_ATTACHMENT1, FrameBufferIDTexture, 0);
-
-
-		glTextureStorage2D(FrameBufferHitPosTexture, 1, GL_RGBA32F, 1080, 1080);
-		glNamedFramebufferTexture(FrameBufferID, GL_COLOR_ATTACHMENT2, FrameBufferHitPosTexture, 0);
-
+		if (HasAttachment(_attachments, Attachment::ID) && FrameBufferIDTexture == 0)
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferIDTexture);
+			ResizeAttachment(FrameBufferIDTexture, GL_R32I, GL_RED_INTEGER, GL_INT);
+			glNamedFramebufferTexture(FrameBufferID, GL_COLOR_ATTACHMENT1, FrameBufferIDTexture, 0);
+		}
 
-		glTextureStorage2D(FrameBufferDepthTexture, 1, GL_DEPTH_COMPONENT32F, 1080, 1080);
-		glNamedFramebufferTexture(FrameBufferID, GL_DEPTH_ATTACHMENT, FrameBufferDepthTexture, 0);
+		if (HasAttachment(_attachments, Attachment::Depth) && FrameBufferDepthTexture == 0)
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &FrameBufferDepthTexture);
+			ResizeAttachment(FrameBufferDepthTexture, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT);
+			glNamedFramebufferTexture(FrameBufferID, GL_DEPTH_ATTACHMENT, FrameBufferDepthTexture, 0);
+		}
 
 		auto status = glCheckNamedFramebufferStatus(FrameBufferID, GL_FRAMEBUFFER);
 		if (status != GL_FRAMEBUFFER_COMPLETE)
@@ -45,14 +89,53 @@ public:
 		}
 	}
 
+	// Binds the frame buffer with only _attachments as draw buffers, sets the viewport to
+	// _renderSize and clears them. The attachments follow _windowSize, which is kept for mapping mouse reads.
+	inline static void BeginPass(Attachment _attachments, const glm::ivec2& _renderSize, const glm::ivec2& _windowSize, int _upscaleFactor = 0)
+	{
+		AllocateAttachments(_attachments, _windowSize);
+		glBindFramebuffer(GL_FRAMEBUFFER, FrameBufferID);
+		glViewport(0, 0, _renderSize.x, _renderSize.y);
+
+		GLenum buffers[] = {
+			HasAttachment(_attachments, Attachment::Color) ? (GLenum)GL_COLOR_ATTACHMENT0 : (GLenum)GL_NONE,
+			HasAttachment(_attachments, Attachment::ID) ? (GLenum)GL_COLOR_ATTACHMENT1 : (GLenum)GL_NONE };
+		glNamedFramebufferDrawBuffers(FrameBufferID, 2, buffers);
+
+		// Color
+		if (HasAttachment(_attachments, Attachment::Color))
+			glClearNamedFramebufferfv(FrameBufferID, GL_COLOR, 0, BackgroundColor);
+
+		// Id's
+		if (HasAttachment(_attachments, Attachment::ID))
+		{
+			GLint clearID = -1;
+			glClearNamedFramebufferiv(FrameBufferID, GL_COLOR, 1, &clearID);
+		}
+
+		if (HasAttachment(_attachments, Attachment::Depth))
+		{
+			GLfloat clearDepth = 1.0f;
+			glClearNamedFramebufferfv(FrameBufferID, GL_DEPTH, 0, &clearDepth);
+		}
+
+		m_Attachments = _attachments;
+		m_PassSize = _renderSize;
+		m_PassWindowSize = _windowSize;
+		m_PassUpscaleFactor = _upscaleFactor;
+	}
+
 	inline static void ClearTexturesCustom()
 	{
 		// Color
 		glClearNamedFramebufferfv(FrameBufferID, GL_COLOR, 0, BackgroundColor);
 
 		// Id's
-		const GLint clearID = -1;
-		glClearTexImage(FrameBufferIDTexture, 0, GL_RED_INTEGER, GL_INT, &clearID);
+		if (FrameBufferIDTexture != 0)
+		{
+			const GLint clearID = -1;
+			glClearTexImage(FrameBufferIDTexture, 0, GL_RED_INTEGER, GL_INT, &clearID);
+		}
 
 		// Anything else that needs default values
 	}
@@ -66,9 +149,143 @@ public:
 	{
 
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, m_PassWindowSize.x, m_PassWindowSize.y);
 		glBindTextureUnit(0, FrameBufferTexture);
 	}
 
+	// Recorded Versions For The Render Thread
+	inline static void Bind(CommandBuffer& _commands)
+	{
+		_commands.BindFrameBuffer(FrameBufferID);
+	}
+
+	// Also restores the window viewport for the composite
+	inline static void UnBind(CommandBuffer& _commands)
+	{
+		_commands.BindFrameBuffer(0);
+		_commands.Callback([](const void* _payload)
+			{
+				const glm::ivec2& window = *static_cast<const glm::ivec2*>(_payload);
+				glViewport(0, 0, window.x, window.y);
+			}, &m_WindowSize, sizeof(m_WindowSize));
+		_commands.BindTextureUnit(0, FrameBufferTexture);
+	}
+
+	inline static void ClearTexturesCustom(CommandBuffer& _commands)
+	{
+		_commands.Callback([](const void*) { ClearTexturesCustom(); });
+	}
+
+	// Captures this frame's render and window size, so a size change never lands mid frame
+	inline static void BeginPass(CommandBuffer& _commands, Attachment _attachments)
+	{
+		struct PassPayload
+		{
+			Attachment Attachments;
+			glm::ivec2 RenderSize;
+			glm::ivec2 WindowSize;
+			int UpscaleFactor;
+		};
+		PassPayload pass{ _attachments, GetRenderSize(), m_WindowSize, GetUpscaleFactor() };
+		_commands.Callback([](const void* _payload)
+			{
+				const PassPayload& pass = *static_cast<const PassPayload*>(_payload);
+				BeginPass(pass.Attachments, pass.RenderSize, pass.WindowSize, pass.UpscaleFactor);
+			}, &pass, sizeof(pass));
+	}
+
+	// Simulation Thread, picked up by the next recorded pass
+	// Attachment size, the largest render size
+	inline static glm::ivec2 GetMaxSize() { return m_WindowSize; }
+	// Fraction of the max size to render at, kept as a fraction so it follows window resizes
+	inline static void SetRenderScale(float _scale) { m_RenderScale = _scale; }
+	// Render size rounded to whole RenderSizeStep blocks
+	inline static glm::ivec2 GetRenderSize()
+	{
+		glm::ivec2 maxSize = GetMaxSize();
+		if (m_IsPixelPerfect)
+			return glm::min(GetVirtualSize(), maxSize);
+		glm::ivec2 size = glm::ivec2(glm::round(glm::vec2(maxSize) * m_RenderScale / (float)RenderSizeStep)) * RenderSizeStep;
+		return glm::min(glm::max(size, glm::ivec2(RenderSizeStep)), maxSize);
+	}
+	// Fraction of the attachments covered by the render size, what the composite samples
+	inline static glm::vec2 GetRenderScale() { return glm::vec2(GetRenderSize()) / glm::vec2(GetMaxSize()); }
+
+	// Renders at GetVirtualSize and upscales by whole window pixels, the scaled render size comes back when turned off
+	inline static void SetPixelPerfect(bool _pixelPerfect) { m_IsPixelPerfect = _pixelPerfect; }
+	inline static bool IsPixelPerfect() { return m_IsPixelPerfect; }
+	// Window pixels per render pixel in pixel perfect mode, 0 when the composite stretches instead
+	inline static int GetUpscaleFactor()
+	{
+		if (!m_IsPixelPerfect)
+			return 0;
+		glm::ivec2 factor = m_WindowSize / GetVirtualSize();
+		return glm::max(glm::min(factor.x, factor.y), 1);
+	}
+	// Window pixels left of and below the upscaled image
+	inline static glm::ivec2 GetUpscaleOffset(const glm::ivec2& _windowSize, const glm::ivec2& _renderSize, int _upscaleFactor)
+	{
+		return (_windowSize - _renderSize * _upscaleFactor) / 2;
+	}
+	inline static void SetWindowSize(const glm::ivec2& _windowSize) { m_WindowSize = glm::max(_windowSize, glm::ivec2(1)); }
+	inline static glm::ivec2 GetWindowSize() { return m_WindowSize; }
+	// VirtualHeight rows with the window's aspect, so the upscaled image fills the window like the view does
+	inline static glm::ivec2 GetVirtualSize()
+	{
+		int width = (int)glm::round((float)VirtualHeight * m_WindowSize.x / m_WindowSize.y);
+		return { glm::max(width, 1), VirtualHeight };
+	}
+
+	// _mouse in window pixels from the top left to the render target pixel from the bottom left it lands on,
+	// through the whole factor upscale when _upscaleFactor is set. Matches the mapping in frameBuffer.frag
+	inline static glm::ivec2 WindowToRenderPixel(const glm::dvec2& _mouse, const glm::ivec2& _windowSize, const glm::ivec2& _renderSize, int _upscaleFactor = 0)
+	{
+		glm::ivec2 pixel;
+		if (_upscaleFactor > 0)
+		{
+			glm::dvec2 window = { _mouse.x, _windowSize.y - _mouse.y };
+			glm::dvec2 offset = GetUpscaleOffset(_windowSize, _renderSize, _upscaleFactor);
+			pixel = glm::ivec2(glm::floor((window - offset) / (double)_upscaleFactor));
+		}
+		else
+		{
+			glm::dvec2 uv = { _mouse.x / _windowSize.x, 1.0 - _mouse.y / _windowSize.y };
+			pixel = glm::ivec2(glm::floor(uv * glm::dvec2(_renderSize)));
+		}
+		return glm::clamp(pixel, glm::ivec2(0), _renderSize - 1);
+	}
+
+	// Bytes of attachments allocated so far
+	inline static size_t GetAttachmentBytes() { return m_AttachmentBytes; }
+
+	// Reads the ID and the world position beside it once the frame is replayed, the results land in
+	// PickedID and GetPickedPosition. The position is in the space of _inverseViewProjection
+	inline static void GrabIDUnderMouse(CommandBuffer& _commands, double _mouseX, double _mouseY, const glm::mat4& _inverseViewProjection)
+	{
+		struct PickPayload
+		{
+			glm::mat4 InverseViewProjection;
+			double Mouse[2];
+		};
+		PickPayload pick{ _inverseViewProjection, { _mouseX, _mouseY } };
+		_commands.Callback([](const void* _payload)
+			{
+				const PickPayload& pick = *static_cast<const PickPayload*>(_payload);
+				PickedID = GrabIDUnderMouse(double(pick.Mouse[0]), double(pick.Mouse[1]));
+				glm::vec3 position = GrabMousePositionIn3D(double(pick.Mouse[0]), double(pick.Mouse[1]), pick.InverseViewProjection);
+				Print(FrameAllocator::Format("%f|%f|%f", position.x, position.y, position.z));
+
+				std::lock_guard<std::mutex> lock(m_PickedPositionMutex);
+				m_PickedPosition = position;
+			}, &pick, sizeof(pick));
+	}
+
+	inline static glm::vec3 GetPickedPosition()
+	{
+		std::lock_guard<std::mutex> lock(m_PickedPositionMutex);
+		return m_PickedPosition;
+	}
+
 	inline static void Cleanup()
 	{
 		glBindTexture(GL_TEXTURE_2D, 0);
@@ -77,22 +294,24 @@ public:
 		glDeleteTextures(1, &FrameBufferTexture);
 		glDeleteTextures(1, &FrameBufferIDTexture);
 		glDeleteTextures(1, &FrameBufferDepthTexture);
-		glDeleteTextures(1, &FrameBufferHitPosTexture);
+		FrameBufferTexture = FrameBufferIDTexture = FrameBufferDepthTexture = 0;
+		m_AttachmentSize = glm::ivec2(0);
+		m_AttachmentBytes = 0;
 	}
 
 	inline static int GrabIDUnderMouse(double&& _mouseX, double&& _mouseY)
 	{
+		// IDs are only drawn by pick passes
+		if (!HasAttachment(m_Attachments, Attachment::ID))
+			return -1;
+
 		glBindFramebuffer(GL_FRAMEBUFFER, FrameBuffer::FrameBufferID);
-		GLenum buffers[] = { GL_COLOR_ATTACHMENT0 , GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_DEPTH_ATTACHMENT };
-		glDrawBuffers(2, buffers);
 		glReadBuffer(GL_COLOR_ATTACHMENT1);
 
-		int* pixels = new int;
-		glReadPixels(_mouseX, 1080 - _mouseY, 1, 1, GL_RED_INTEGER, GL_INT, pixels);
-		int returnValue = *pixels;
-		Print(*pixels);
-		delete pixels;
-		pixels = nullptr;
+		glm::ivec2 pixel = WindowToRenderPixel({ _mouseX, _mouseY }, m_PassWindowSize, m_PassSize, m_PassUpscaleFactor);
+		int returnValue = -1;
+		glReadPixels(pixel.x, pixel.y, 1, 1, GL_RED_INTEGER, GL_INT, &returnValue);
+		Print(returnValue);
 
 		glReadBuffer(GL_NONE);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -102,19 +321,13 @@ public:
 
 	inline static float GrabDepthUnderMouse(double&& _mouseX, double&& _mouseY)
 	{
+		// Depth reads ignore the read buffer
 		glBindFramebuffer(GL_FRAMEBUFFER, FrameBuffer::FrameBufferID);
-		GLenum buffers[] = { GL_COLOR_ATTACHMENT0 , GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_DEPTH_ATTACHMENT };
-		glDrawBuffers(4, buffers);
-		glReadBuffer(GL_DEPTH_ATTACHMENT);
 
-		float* pixels = new float;
-		glReadPixels(_mouseX, 1080 - _mouseY, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, pixels);
-		float returnValue = *pixels;
-		Print(*pixels);
-		delete pixels;
-		pixels = nullptr;
+		glm::ivec2 pixel = WindowToRenderPixel({ _mouseX, _mouseY }, m_PassWindowSize, m_PassSize, m_PassUpscaleFactor);
+		float returnValue = 1.0f;
+		glReadPixels(pixel.x, pixel.y, 1, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &returnValue);
 
-		glReadBuffer(GL_NONE);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		return returnValue;
@@ -123,25 +336,13 @@ public:
 	inline static glm::vec3 GrabColourUnderMouse(double&& _mouseX, double&& _mouseY)
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, FrameBuffer::FrameBufferID);
-
-		GLenum buffers[] = { GL_COLOR_ATTACHMENT0 , GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_DEPTH_ATTACHMENT };
-		glDrawBuffers(1, buffers);
 		glReadBuffer(GL_COLOR_ATTACHMENT0);
 
-		GLfloat* pixels = new GLfloat[4];
-		glReadPixels(_mouseX, 1080 - _mouseY, 1, 1, GL_RGBA, GL_FLOAT, pixels);
+		glm::ivec2 pixel = WindowToRenderPixel({ _mouseX, _mouseY }, m_PassWindowSize, m_PassSize, m_PassUpscaleFactor);
+		GLfloat pixels[4] = {};
+		glReadPixels(pixel.x, pixel.y, 1, 1, GL_RGBA, GL_FLOAT, pixels);
 		glm::vec3 returnValue = { pixels[0], pixels[1], pixels[2] };
-		{
-			std::string output = "";
-			output += std::to_string(pixels[0]);
-			output += "|";
-			output += std::to_string(pixels[1]);
-			output += "|";
-			output += std::to_string(pixels[2]);
-			Print(output);
-		}
-		delete[] pixels;
-		pixels = nullptr;
+		Print(FrameAllocator::Format("%f|%f|%f", pixels[0], pixels[1], pixels[2]));
 
 		glReadBuffer(GL_NONE);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -149,43 +350,62 @@ public:
 		return returnValue;
 	}
 
-	inline static glm::vec3 GrabMousePositionIn3D(double&& _mouseX, double&& _mouseY)
+	// One depth sample under the mouse taken back through _inverseViewProjection, so the result is
+	// in whatever space the matrices came from (relative to the camera's floating origin for Camera)
+	inline static glm::vec3 GrabMousePositionIn3D(double&& _mouseX, double&& _mouseY, const glm::mat4& _inverseViewProjection)
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, FrameBuffer::FrameBufferID);
+		float depth = GrabDepthUnderMouse(double(_mouseX), double(_mouseY));
+		glm::ivec2 pixel = WindowToRenderPixel({ _mouseX, _mouseY }, m_PassWindowSize, m_PassSize, m_PassUpscaleFactor);
+		return ReconstructPosition(glm::vec2(pixel), depth, _inverseViewProjection, m_PassSize);
+	}
 
-		GLenum buffers[] = { GL_COLOR_ATTACHMENT0 , GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_DEPTH_ATTACHMENT };
-		glDrawBuffers(3, buffers);
-		glReadBuffer(GL_COLOR_ATTACHMENT2);
+	// _pixel in frame buffer pixels from the bottom left of a pass rendered at _renderSize, _depth as
+	// stored in the depth attachment (0 - 1). Matches GrabPositionFromDepth in frameBuffer.frag
+	inline static glm::vec3 ReconstructPosition(const glm::vec2& _pixel, float _depth, const glm::mat4& _inverseViewProjection, const glm::ivec2& _renderSize)
+	{
+		glm::vec4 clip = { (_pixel.x + 0.5f) / _renderSize.x * 2.0f - 1.0f, (_pixel.y + 0.5f) / _renderSize.y * 2.0f - 1.0f, _depth * 2.0f - 1.0f, 1.0f };
+		glm::vec4 world = _inverseViewProjection * clip;
+		return glm::vec3(world) / world.w;
+	}
 
-		GLfloat* pixels = new GLfloat[4];
-		glReadPixels(_mouseX, 1080 - _mouseY, 1, 1, GL_RGBA, GL_FLOAT, pixels);
-		glm::vec3 returnValue = { pixels[0], pixels[1], pixels[2] };
-		{
-			std::string output = "";
-			output += std::to_string(pixels[0]);
-			output += "|";
-			output += std::to_string(pixels[1]);
-			output += "|";
-			output += std::to_string(pixels[2]);
-			output += "|";
-			output += std::to_string(pixels[3]);
-			Print(output);
-		}
-		delete[] pixels;
-		pixels = nullptr;
+	inline static unsigned FrameBufferTexture = 0;
+	inline static unsigned FrameBufferDepthTexture = 0;
+	inline static unsigned FrameBufferIDTexture = 0;
+	inline static unsigned FrameBufferID = 0;
 
-		glReadBuffer(GL_NONE);
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	static const GLsizei RenderSizeStep = 8;
+	// Pixel perfect render height, what the art is authored for
+	static const int VirtualHeight = 270;
 
-		return returnValue;
-	}
+	inline static GLfloat BackgroundColor[4];
+	inline static std::atomic<int> PickedID{ -1 };
 
-	inline static unsigned FrameBufferTexture;
-	inline static unsigned FrameBufferDepthTexture;
-	inline static unsigned FrameBufferIDTexture;
-	inline static unsigned FrameBufferHitPosTexture;
-	inline static unsigned FrameBufferID;
+private:
+	// Mutable storage so the names survive a resize, the composite and picking hold on to them
+	inline static void ResizeAttachment(GLuint _texture, GLenum _internalFormat, GLenum _format, GLenum _type)
+	{
+		if (_texture == 0)
+			return;
+		glTextureParameteri(_texture, GL_TEXTURE_MAX_LEVEL, 0);
+		glBindTexture(GL_TEXTURE_2D, _texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, _internalFormat, m_AttachmentSize.x, m_AttachmentSize.y, 0, _format, _type, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		m_AttachmentBytes += (size_t)m_AttachmentSize.x * m_AttachmentSize.y * 4;
+	}
 
-	inline static GLfloat BackgroundColor[4];
+	// Simulation Thread
+	inline static float m_RenderScale = 1.0f;
+	inline static glm::ivec2 m_WindowSize{ 1080, 1080 };
+	inline static bool m_IsPixelPerfect = false;
+
+	// Render Thread
+	inline static Attachment m_Attachments = Attachment::None;
+	inline static glm::ivec2 m_AttachmentSize{ 0 };
+	inline static glm::ivec2 m_PassSize{ 1080, 1080 };
+	inline static glm::ivec2 m_PassWindowSize{ 1080, 1080 };
+	inline static int m_PassUpscaleFactor = 0;
+	inline static size_t m_AttachmentBytes = 0;
+	inline static std::mutex m_PickedPositionMutex;
+	inline static glm::vec3 m_PickedPosition{ 0.0f };
 };
 
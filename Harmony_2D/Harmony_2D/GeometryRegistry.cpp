@@ -0,0 +1,125 @@
+#include "GeometryRegistry.h"
+#include "FrameAllocator.h"
+#include "Mesh.h"
+#include <cassert>
+#include <cstring>
+
+void GeometryRegistry::Init(size_t _maxVertices, size_t _maxIndices)
+{
+	m_MaxVertices = _maxVertices;
+	m_MaxIndices = _maxIndices;
+
+	// Shared Buffers, Written With glNamedBufferSubData
+	glCreateBuffers(1, &VertBufferID);
+	glNamedBufferStorage(VertBufferID, m_MaxVertices * sizeof(Vertex), nullptr, GL_DYNAMIC_STORAGE_BIT);
+	glCreateBuffers(1, &IndexBufferID);
+	glNamedBufferStorage(IndexBufferID, m_MaxIndices * sizeof(unsigned), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	// Vertex Array
+	glCreateVertexArrays(1, &VertexArrayID);
+	Mesh::GetVertexLayout().Apply(VertexArrayID, VertBufferID);
+	glVertexArrayElementBuffer(VertexArrayID, IndexBufferID);
+}
+
+void GeometryRegistry::Shutdown()
+{
+	glDeleteVertexArrays(1, &VertexArrayID);
+	glDeleteBuffers(1, &VertBufferID);
+	glDeleteBuffers(1, &IndexBufferID);
+	VertexArrayID = VertBufferID = IndexBufferID = 0;
+
+	m_Entries.clear();
+	m_EntryIndex.clear();
+	m_VertexCount = m_IndexCount = m_Requests = 0;
+	m_UnsharedBytes = 0;
+}
+
+Geometry GeometryRegistry::Add(const std::vector<Vertex>& _vertices, const std::vector<unsigned>& _indices, bool _isUnique)
+{
+	size_t bytes = _vertices.size() * sizeof(Vertex) + _indices.size() * sizeof(unsigned);
+	m_Requests++;
+	m_UnsharedBytes += bytes;
+
+	// Reuse Identical Geometry
+	size_t hash = Hash(_vertices, _indices);
+	if (!_isUnique)
+	{
+		auto [first, last] = m_EntryIndex.equal_range(hash);
+		for (auto it = first; it != last; it++)
+		{
+			const Entry& item = m_Entries[it->second];
+			if (item.Vertices.size() == _vertices.size() && item.Indices.size() == _indices.size() &&
+				std::memcmp(item.Vertices.data(), _vertices.data(), _vertices.size() * sizeof(Vertex)) == 0 &&
+				std::memcmp(item.Indices.data(), _indices.data(), _indices.size() * sizeof(unsigned)) == 0)
+			{
+				return item.Placement;
+			}
+		}
+	}
+
+	// Out Of Space, Init was given too small a budget for the scene
+	if (m_VertexCount + _vertices.size() > m_MaxVertices || m_IndexCount + _indices.size() > m_MaxIndices)
+	{
+		Print(FrameAllocator::Format("Geometry Registry Is Full: %u + %u / %u Vertices, %u + %u / %u Indices",
+			m_VertexCount, (unsigned)_vertices.size(), (unsigned)m_MaxVertices, m_IndexCount, (unsigned)_indices.size(), (unsigned)m_MaxIndices));
+		assert(false && "GeometryRegistry::Init budget exceeded");
+		return {};
+	}
+
+	// Append
+	Geometry geometry;
+	geometry.VertexArrayID = VertexArrayID;
+	geometry.BaseVertex = (GLint)m_VertexCount;
+	geometry.VertexCount = (unsigned)_vertices.size();
+	geometry.FirstIndex = m_IndexCount;
+	geometry.IndexCount = (unsigned)_indices.size();
+	glNamedBufferSubData(VertBufferID, (GLintptr)m_VertexCount * sizeof(Vertex), _vertices.size() * sizeof(Vertex), _vertices.data());
+	glNamedBufferSubData(IndexBufferID, (GLintptr)m_IndexCount * sizeof(unsigned), _indices.size() * sizeof(unsigned), _indices.data());
+	m_VertexCount += geometry.VertexCount;
+	m_IndexCount += geometry.IndexCount;
+
+	// Unique geometry is never matched, so keeps no copy
+	Entry entry;
+	entry.Hash = hash;
+	entry.Placement = geometry;
+	if (!_isUnique)
+	{
+		entry.Vertices = _vertices;
+		entry.Indices = _indices;
+		m_EntryIndex.emplace(hash, (uint32_t)m_Entries.size());
+	}
+	m_Entries.push_back(std::move(entry));
+
+	return geometry;
+}
+
+GeometryStats GeometryRegistry::GetStats()
+{
+	GeometryStats stats;
+	stats.Requests = m_Requests;
+	stats.Unique = (unsigned)m_Entries.size();
+	stats.VertexArrays = VertexArrayID != 0 ? 1 : 0;
+	stats.Buffers = (VertBufferID != 0 ? 1 : 0) + (IndexBufferID != 0 ? 1 : 0);
+	stats.UsedBytes = (size_t)m_VertexCount * sizeof(Vertex) + (size_t)m_IndexCount * sizeof(unsigned);
+	stats.CapacityBytes = m_MaxVertices * sizeof(Vertex) + m_MaxIndices * sizeof(unsigned);
+	stats.UnsharedBytes = m_UnsharedBytes;
+	return stats;
+}
+
+size_t GeometryRegistry::Hash(const std::vector<Vertex>& _vertices, const std::vector<unsigned>& _indices)
+{
+	// FNV-1a over the raw bytes
+	size_t hash = 14695981039346656037ull;
+	auto mix = [&hash](const void* _data, size_t _size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(_data);
+		for (size_t i = 0; i < _size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+	mix(_vertices.data(), _vertices.size() * sizeof(Vertex));
+	mix(_indices.data(), _indices.size() * sizeof(unsigned));
+	return hash;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "VertexLayout.h"
+
+// Where a piece of geometry lives in the shared buffers. Indices are local to the geometry,
+// draw with glDrawElementsBaseVertex(FirstIndex, BaseVertex).
+struct Geometry
+{
+	GLuint VertexArrayID = 0;
+	GLint BaseVertex = 0;
+	unsigned VertexCount = 0;
+	unsigned FirstIndex = 0;
+	unsigned IndexCount = 0;
+};
+
+// Counts for the shared buffers against what one VAO / VBO / IBO per request would have cost
+struct GeometryStats
+{
+	unsigned Requests = 0;
+	unsigned Unique = 0;
+	unsigned VertexArrays = 0;
+	unsigned Buffers = 0;
+	size_t UsedBytes = 0;
+	size_t CapacityBytes = 0;
+	size_t UnsharedBytes = 0;
+};
+
+// Owns every mesh's vertices and indices in one vertex buffer and one index buffer behind one
+// vertex array (Mesh::GetVertexLayout). Immutable geometry is deduplicated by content hash,
+// so identical quads share one range. Geometry a caller rewrites (_isUnique) always gets its own range.
+static class GeometryRegistry
+{
+public:
+	static void Init(size_t _maxVertices = 65536, size_t _maxIndices = 196608);
+	static void Shutdown();
+
+	static Geometry Add(const std::vector<Vertex>& _vertices, const std::vector<unsigned>& _indices, bool _isUnique = false);
+
+	inline static GLuint GetVertexBuffer() { return VertBufferID; }
+	static GeometryStats GetStats();
+
+private:
+	static size_t Hash(const std::vector<Vertex>& _vertices, const std::vector<unsigned>& _indices);
+
+	struct Entry
+	{
+		size_t Hash = 0;
+		Geometry Placement;
+		std::vector<Vertex> Vertices;
+		std::vector<unsigned> Indices;
+	};
+
+	inline static GLuint VertexArrayID = 0;
+	inline static GLuint VertBufferID = 0;
+	inline static GLuint IndexBufferID = 0;
+
+	inline static std::vector<Entry> m_Entries;
+	inline static std::unordered_multimap<size_t, uint32_t> m_EntryIndex;
+	inline static size_t m_MaxVertices = 0;
+	inline static size_t m_MaxIndices = 0;
+	inline static unsigned m_VertexCount = 0;
+	inline static unsigned m_IndexCount = 0;
+	inline static unsigned m_Requests = 0;
+	inline static size_t m_UnsharedBytes = 0;
+};
@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
 #include <vector>
 #include <unordered_map>
 #include <map>
@@ -24,21 +25,52 @@ struct UniformLocation
     const char* location;
 };
 
+// 8 byte mesh vertex (Mesh::GetVertexLayout). Meshes are quads in -1 - 1 model space, so the position
+// packs to snorm16 x / y with z left to the model matrix, and UVs pack to unorm16
 struct Vertex
 {
-	glm::vec3 position;
-	glm::vec2 texCoords;
+	GLuint position;
+	GLuint texCoords;
+
+	Vertex() = default;
+	Vertex(const glm::vec3& _position, const glm::vec2& _texCoords)
+		: position(glm::packSnorm2x16(glm::vec2(_position))), texCoords(glm::packUnorm2x16(_texCoords)) {}
 };
 
+// 48 byte std430 sprite record read by sprite.vert, which builds the quad from gl_VertexID.
+// Translation is relative to the floating origin and the 2x2 part stays full float, half floats
+// lose a third of a pixel on large sprites. The layer travels with the sprite so draws never split on it.
+struct SpriteInstance
+{
+	GLfloat x, y;
+	GLfloat a, b, c, d;    // 2x2, columns ab and cd
+	GLuint uvMin, uvMax;   // packUnorm2x16, or for flipbooks clip | half speed << 16 and the float start time
+	GLuint color;          // RGBA8
+	GLuint id;             // pick ID in bits 0 - 23, texture array layer in 24 - 30, flipbook flag in 31
+	GLfloat layer;
+	GLuint padding;        // std430 rounds the record up to its vec2 alignment
+};
+static_assert(sizeof(SpriteInstance) == 48, "SpriteInstance must match the std430 array stride");
+
 struct Transform
 {
     glm::mat4 tranform = glm::mat4(1);
     glm::vec3 rotation_axis = { 0,0,0 };
-    glm::vec3 translation = {0,0,0};
+    glm::dvec3 translation = {0,0,0};
     glm::vec3 scale = {1,1,1};
     GLfloat rotation_value = 0.0f;
 };
 
+// 2D affine matrix, column major
+// | a c tx |
+// | b d ty |
+struct Affine2D
+{
+    float a = 1.0f, b = 0.0f;
+    float c = 0.0f, d = 1.0f;
+    float tx = 0.0f, ty = 0.0f;
+};
+
 struct Texture
 {
 	GLuint ID = 0;
@@ -46,10 +78,23 @@ struct Texture
 	const char* FilePath = "";
 };
 
-static inline glm::mat4& UpdateModelValueOfTransform(Transform& _transform)
+// One image stored as a layer of a GL_TEXTURE_2D_ARRAY. Images are padded up to their array's
+// size, so UVs over the image are scaled by UVScale (the padding sits above and to the right).
+struct TextureLayer
+{
+	GLuint ArrayID = 0;
+	GLuint Layer = 0;
+	glm::vec2 UVScale{ 1.0f };
+	glm::vec2 Dimensions{ 0 };
+	const char* FilePath = "";
+};
+
+// Translation is stored in double precision world space and made relative to _origin
+// (the camera's floating origin) before being narrowed to float for the model matrix.
+static inline glm::mat4& UpdateModelValueOfTransform(Transform& _transform, const glm::dvec3& _origin = glm::dvec3(0))
 {
 	_transform.tranform = glm::mat4(1);
-	_transform.tranform = glm::translate(_transform.tranform, _transform.translation);
+	_transform.tranform = glm::translate(_transform.tranform, glm::vec3(_transform.translation - _origin));
 	if (_transform.rotation_axis.x > 0 ||
 		_transform.rotation_axis.y > 0 ||
 		_transform.rotation_axis.z > 0)
@@ -60,18 +105,41 @@ static inline glm::mat4& UpdateModelValueOfTransform(Transform& _transform)
 	return _transform.tranform;
 }
 
+// _parent * _child
+static inline Affine2D MultiplyAffine(const Affine2D& _parent, const Affine2D& _child)
+{
+	return
+	{
+		_parent.a * _child.a + _parent.c * _child.b,
+		_parent.b * _child.a + _parent.d * _child.b,
+		_parent.a * _child.c + _parent.c * _child.d,
+		_parent.b * _child.c + _parent.d * _child.d,
+		_parent.a * _child.tx + _parent.c * _child.ty + _parent.tx,
+		_parent.b * _child.tx + _parent.d * _child.ty + _parent.ty
+	};
+}
+
+static inline glm::mat4 AffineToModelMatrix(const Affine2D& _affine, float _layer = 0.0f)
+{
+	glm::mat4 model(1);
+	model[0] = { _affine.a, _affine.b, 0.0f, 0.0f };
+	model[1] = { _affine.c, _affine.d, 0.0f, 0.0f };
+	model[3] = { _affine.tx, _affine.ty, _layer, 1.0f };
+	return model;
+}
+
 static inline void Print(std::string_view _string)
 {
-	std::cout << _string << std::endl;
+	std::cout << _string << '\n';
 }
 
 static inline void Print(const int& _int)
 {
-	std::cout << _int << std::endl;
+	std::cout << _int << '\n';
 }
 
 static inline void Print(const float& _float)
 {
-	std::cout << _float << std::endl;
+	std::cout << _float << '\n';
 }
 
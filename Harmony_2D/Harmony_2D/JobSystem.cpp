@@ -0,0 +1,222 @@
+#include "JobSystem.h"
+
+bool JobQueue::Push(const Job& _job)
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	if (bottom - top >= (int64_t)Capacity)
+		return false;
+
+	m_Jobs[bottom % Capacity] = _job;
+	m_Bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+bool JobQueue::Pop(Job& _job)
+{
+	// Claim The Bottom Slot Before Looking At The Top
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_Top.load(std::memory_order_relaxed);
+	if (top > bottom)
+	{
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	_job = m_Jobs[bottom % Capacity];
+	if (top == bottom)
+	{
+		// Last Job, Race The Thieves For It
+		bool isWon = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return isWon;
+	}
+	return true;
+}
+
+bool JobQueue::Steal(Job& _job)
+{
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return false;
+
+	_job = m_Jobs[top % Capacity];
+	return m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+void JobSystem::Init(unsigned _workerCount)
+{
+	Shutdown();
+
+	m_WorkerCount = _workerCount == 0 ? 1 : _workerCount;
+	for (unsigned i = 0; i < m_WorkerCount; i++)
+	{
+		m_Queues.push_back(new JobQueue());
+	}
+
+	// Worker 0 Is The Calling Thread
+	t_WorkerIndex = 0;
+	m_Running = true;
+	for (unsigned i = 1; i < m_WorkerCount; i++)
+	{
+		m_Threads.emplace_back(WorkerLoop, i);
+	}
+}
+
+void JobSystem::Shutdown()
+{
+	m_Running = false;
+	{
+		std::lock_guard<std::mutex> lock(m_WakeMutex);
+		m_WakeCondition.notify_all();
+	}
+	for (auto& item : m_Threads)
+	{
+		item.join();
+	}
+	m_Threads.clear();
+
+	for (auto& item : m_Queues)
+	{
+		delete item;
+		item = nullptr;
+	}
+	m_Queues.clear();
+	m_Parked.clear();
+	m_WorkerCount = 1;
+}
+
+void JobSystem::Run(const Job& _job, JobCounter& _counter)
+{
+	Job job = _job;
+	job.Counter = &_counter;
+	_counter.Pending.fetch_add(1, std::memory_order_relaxed);
+
+	// Dependency Not Finished : Park Until It Signals Zero
+	if (job.Dependency)
+	{
+		std::lock_guard<std::mutex> lock(m_ParkMutex);
+		if (!job.Dependency->IsDone())
+		{
+			m_Parked.push_back(job);
+			return;
+		}
+	}
+
+	Submit(job);
+}
+
+void JobSystem::Wait(const JobCounter& _counter)
+{
+	while (!_counter.IsDone())
+	{
+		if (!TryRunJob(t_WorkerIndex))
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::Signal(JobCounter& _counter)
+{
+	// The counter may be gone once it reads zero, only the parked list is touched after
+	if (_counter.Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		ReleaseParked();
+}
+
+void JobSystem::WorkerLoop(unsigned _workerIndex)
+{
+	t_WorkerIndex = _workerIndex;
+	while (m_Running.load(std::memory_order_acquire))
+	{
+		unsigned epoch = m_WakeEpoch.load();
+		if (TryRunJob(_workerIndex))
+			continue;
+
+		// Sleep Until A Job Is Queued After The Queues Were Found Empty
+		std::unique_lock<std::mutex> lock(m_WakeMutex);
+		m_Sleeping++;
+		m_WakeCondition.wait(lock, [epoch] { return !m_Running.load() || m_WakeEpoch.load() != epoch; });
+		m_Sleeping--;
+	}
+}
+
+bool JobSystem::TryRunJob(unsigned _workerIndex)
+{
+	if (m_Queues.empty())
+		return false;
+
+	// Own Queue First, Then Steal Round Robin
+	Job job;
+	bool found = m_Queues[_workerIndex]->Pop(job);
+	for (unsigned i = 1; !found && i < m_WorkerCount; i++)
+	{
+		found = m_Queues[(_workerIndex + i) % m_WorkerCount]->Steal(job);
+	}
+	if (!found)
+		return false;
+
+	Execute(job);
+	return true;
+}
+
+void JobSystem::Execute(const Job& _job)
+{
+	_job.Function(_job.Data, _job.Begin, _job.End);
+	Signal(*_job.Counter);
+}
+
+void JobSystem::Submit(const Job& _job)
+{
+	// Not Initialised Or Queue Full : Run Inline
+	if (m_Queues.empty() || !m_Queues[t_WorkerIndex]->Push(_job))
+	{
+		Execute(_job);
+		return;
+	}
+
+	Wake();
+}
+
+void JobSystem::ReleaseParked()
+{
+	// Swapped out so a job run inline by Submit can release its own dependents
+	std::vector<Job> released;
+	released.swap(t_Released);
+	{
+		std::lock_guard<std::mutex> lock(m_ParkMutex);
+		for (size_t i = 0; i < m_Parked.size();)
+		{
+			if (m_Parked[i].Dependency->IsDone())
+			{
+				released.push_back(m_Parked[i]);
+				m_Parked[i] = m_Parked.back();
+				m_Parked.pop_back();
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	for (auto& item : released)
+	{
+		Submit(item);
+	}
+	released.clear();
+	t_Released.swap(released);
+}
+
+void JobSystem::Wake()
+{
+	// Epoch first, a worker about to sleep either sees it move or is counted in m_Sleeping
+	m_WakeEpoch.fetch_add(1);
+	if (m_Sleeping.load() == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_WakeMutex);
+	m_WakeCondition.notify_one();
+}
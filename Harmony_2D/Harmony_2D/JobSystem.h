@@ -0,0 +1,117 @@
+#pragma once
+#include "Helper.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Number of outstanding jobs, jobs decrement it when they finish. Jobs depending on a counter
+// are parked until it reaches zero, JobSystem::Signal counts it down from outside a job.
+struct JobCounter
+{
+	std::atomic<int> Pending{ 0 };
+
+	inline bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+};
+
+// POD job over an index range, no heap allocation per job
+struct Job
+{
+	void (*Function)(void* _data, unsigned _begin, unsigned _end) = nullptr;
+	void* Data = nullptr;
+	unsigned Begin = 0;
+	unsigned End = 0;
+	JobCounter* Counter = nullptr;
+	const JobCounter* Dependency = nullptr;
+};
+
+// Fixed size Chase-Lev deque. The owning thread pushes and pops at the bottom without locking,
+// other workers steal from the top with one compare exchange. A thief may copy a slot the owner is
+// overwriting, its compare exchange then fails and the copy is dropped.
+class JobQueue
+{
+public:
+	static const unsigned Capacity = 4096;
+
+	bool Push(const Job& _job);
+	bool Pop(Job& _job);
+	bool Steal(Job& _job);
+
+private:
+	Job m_Jobs[Capacity];
+	alignas(64) std::atomic<int64_t> m_Top{ 0 };
+	alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+};
+
+// Work stealing job system. The calling (main) thread is worker 0 and helps execute jobs
+// while it waits on a counter. Idle workers sleep until a job is queued, each queued job wakes one.
+// Run, Wait and Signal are only called from workers, the queues have one owner each.
+static class JobSystem
+{
+public:
+	static void Init(unsigned _workerCount = std::thread::hardware_concurrency());
+	static void Shutdown();
+
+	// _job runs once its Dependency (if any) reaches zero, the dependency must outlive the job
+	static void Run(const Job& _job, JobCounter& _counter);
+	static void Wait(const JobCounter& _counter);
+	// Counts _counter down by one, releasing the jobs parked on it when it reaches zero
+	static void Signal(JobCounter& _counter);
+
+	// Splits [0, _count) into _grainSize chunks and runs _function(begin, end) on every worker
+	template <typename Function>
+	static void ParallelFor(unsigned _count, unsigned _grainSize, Function&& _function, const JobCounter* _dependency = nullptr)
+	{
+		JobCounter counter;
+		ParallelForAsync(_count, _grainSize, _function, counter, _dependency);
+		Wait(counter);
+	}
+
+	// As ParallelFor but returns once the jobs are queued, _function must outlive _counter
+	template <typename Function>
+	static void ParallelForAsync(unsigned _count, unsigned _grainSize, Function& _function, JobCounter& _counter, const JobCounter* _dependency = nullptr)
+	{
+		if (_count == 0)
+			return;
+
+		_grainSize = _grainSize == 0 ? 1 : _grainSize;
+		Job job;
+		job.Function = [](void* _data, unsigned _begin, unsigned _end) { (*static_cast<Function*>(_data))(_begin, _end); };
+		job.Data = (void*)&_function;
+		job.Dependency = _dependency;
+		for (unsigned begin = 0; begin < _count; begin += _grainSize)
+		{
+			job.Begin = begin;
+			job.End = begin + _grainSize < _count ? begin + _grainSize : _count;
+			Run(job, _counter);
+		}
+	}
+
+	inline static unsigned GetWorkerCount() { return m_WorkerCount; }
+	inline static unsigned GetWorkerIndex() { return t_WorkerIndex; }
+
+private:
+	static void WorkerLoop(unsigned _workerIndex);
+	static bool TryRunJob(unsigned _workerIndex);
+	static void Execute(const Job& _job);
+	static void Submit(const Job& _job);
+	static void ReleaseParked();
+	static void Wake();
+
+	inline static unsigned m_WorkerCount = 1;
+	inline static std::vector<std::thread> m_Threads;
+	inline static std::vector<JobQueue*> m_Queues;
+	inline static std::atomic<bool> m_Running{ false };
+	inline static thread_local unsigned t_WorkerIndex = 0;
+
+	// Jobs waiting on an unfinished Dependency
+	inline static std::mutex m_ParkMutex;
+	inline static std::vector<Job> m_Parked;
+	inline static thread_local std::vector<Job> t_Released;
+
+	// Sleeping workers wait for the epoch to move, Wake bumps it and notifies one
+	inline static std::mutex m_WakeMutex;
+	inline static std::condition_variable m_WakeCondition;
+	inline static std::atomic<unsigned> m_WakeEpoch{ 0 };
+	inline static std::atomic<unsigned> m_Sleeping{ 0 };
+};
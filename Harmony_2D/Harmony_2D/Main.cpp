@@ -1,5 +1,12 @@
 #include "Mesh.h"
+#include "SpriteSystems.h"
 #include "FrameBuffer.h"
+#include "DynamicResolution.h"
+#include "PostProcess.h"
+#include "Benchmark.h"
+#include "RenderThread.h"
+#include "TaskGraph.h"
+#include <cassert>
 
 static double DeltaTime = 0.0;
 static double LastFrame = 0.0;
@@ -8,8 +15,13 @@ static bool IsFirstMouse = true;
 static bool IsMouseActive = false;
 static double MouseX = 0.0, MouseY = 0.0;
 static float Depth = 1;
+static bool IsPickRequested = false;
+static bool IsTraceRequested = false;
+static double PickX = 0.0, PickY = 0.0;
 
 static Camera* SceneCamera = nullptr;
+// View the camera had before pixel perfect mode snapped its aspect to the virtual size
+static glm::vec2 PixelPerfectViewSize{ 0.0f };
 
 static GLFWwindow* RenderWindow = nullptr;
 static std::map<int, bool> Keypresses;
@@ -22,7 +34,26 @@ void Update();
 int Cleanup();
 
 static Mesh* FrameBufferMesh = nullptr;
-static std::vector<Mesh*> Meshes;
+static SpriteBatch* SceneBatch = nullptr;
+static EntityRegistry Registry;
+
+// Frame Systems
+static TaskGraph FrameGraph;
+static CommandBuffer* FrameCommands = nullptr;
+static FrameList<unsigned> VisibleSprites;
+
+// GPU Passes From The Scene To The Window
+static RenderGraph CompositeGraph;
+static unsigned CompositeSource = 0;
+
+// Post Process Effects
+static unsigned BlurEffect = 0;
+static unsigned GradeEffect = 0;
+static unsigned VignetteEffect = 0;
+
+// Debug builds report any frame past warm up that calls global operator new
+static const unsigned AllocationWarmupFrames = 120;
+static const bool AssertOnFrameAllocation = false;
 
 static void CalculateDeltaTime()
 {
@@ -32,6 +63,103 @@ static void CalculateDeltaTime()
 	FrameCounter++;
 }
 
+static void CameraSystem()
+{
+	if (!SceneCamera)
+		return;
+
+	SceneCamera->Movement(DeltaTime);
+
+	// Keep origin relative transforms in step with a rebased camera
+	TransformStore& store = Registry.m_Transforms.m_Store;
+	glm::dvec2 origin = glm::dvec2(SceneCamera->GetOrigin());
+	if (origin != store.GetOrigin())
+		store.Rebase(origin);
+}
+
+static void TransformSystem()
+{
+	SpriteSystems::UpdateTransforms(Registry);
+}
+
+static void HierarchySystem()
+{
+	SpriteSystems::UpdateHierarchy(Registry);
+}
+
+static void CullSystem()
+{
+	// GPU culling keeps every sprite resident and culls them in spriteCull.comp
+	if (!SceneBatch->IsGPUCulling())
+		SpriteSystems::Cull(Registry, SceneCamera->GetViewRect(), VisibleSprites);
+}
+
+static void RenderSystem()
+{
+	CommandBuffer& commands = *FrameCommands;
+	DynamicResolution::BeginFrame(commands);
+
+	// Bind And Clear Frame Buffer, Picking Targets Only When A Pick Reads Them
+	FrameBuffer::BeginPass(commands, IsPickRequested ? FrameBuffer::PickPass : FrameBuffer::ColorPass);
+	OverdrawAnalysis::BeginFrame(commands);
+
+	// Draw Sprites To Frame Buffer
+	OverdrawAnalysis::BeginPass(commands, OverdrawPass::Scene);
+	SpriteSystems::Render(Registry, VisibleSprites, *SceneBatch, commands);
+	OverdrawAnalysis::EndPass(commands, OverdrawPass::Scene);
+
+	if (IsPickRequested)
+	{
+		FrameBuffer::GrabIDUnderMouse(commands, PickX, PickY, glm::inverse(SceneCamera->GetProjectionMatrix() * SceneCamera->GetViewMatrix()));
+		IsPickRequested = false;
+	}
+}
+
+static void CompositePass(RenderGraph& _graph, CommandBuffer& _commands, unsigned _pass, const void* _data)
+{
+	_graph.BindRenderTargets(_commands, _pass, FrameBuffer::GetWindowSize());
+	PostProcess::BeginComposite(_graph, _commands, *static_cast<const unsigned*>(_data));
+
+	OverdrawAnalysis::BeginPass(_commands, OverdrawPass::Composite);
+	if (FrameBufferMesh != nullptr)
+		FrameBufferMesh->Record(_commands);
+	OverdrawAnalysis::EndPass(_commands, OverdrawPass::Composite);
+	PostProcess::EndFrame(_commands);
+}
+
+static void CompositeSystem()
+{
+	CommandBuffer& commands = *FrameCommands;
+
+	// Draw Frame Buffer To Screen
+	commands.Disable(GL_DEPTH_TEST);
+
+	FrameBuffer::UnBind(commands);
+	OverdrawAnalysis::ResolveCounts(commands);
+
+	// The scene's attachments stay outside the graph, picking reads them after the frame
+	CompositeGraph.Reset();
+	const glm::ivec2 maxSize = FrameBuffer::GetMaxSize();
+	unsigned scene = CompositeGraph.Import("Scene", FrameBuffer::FrameBufferTexture, { maxSize, GL_RGBA8 });
+	unsigned counts = CompositeGraph.Import("Overdraw Counts", OverdrawAnalysis::GetCountTexture(), { maxSize, GL_R32UI });
+	unsigned window = CompositeGraph.Import("Window", 0, { FrameBuffer::GetWindowSize(), GL_RGBA8 });
+	unsigned result = PostProcess::AddPasses(CompositeGraph, commands, scene);
+
+	// The heatmap ignores the effects, so their passes get culled
+	CompositeSource = OverdrawAnalysis::IsEnabled() ? scene : result;
+	unsigned composite = CompositeGraph.AddPass("Composite", CompositePass, &CompositeSource);
+	CompositeGraph.Read(composite, CompositeSource);
+	if (OverdrawAnalysis::IsEnabled())
+		CompositeGraph.Read(composite, counts);
+	CompositeGraph.Write(composite, window);
+	CompositeGraph.Execute(commands);
+
+	OverdrawAnalysis::EndFrame(commands);
+
+	commands.Enable(GL_DEPTH_TEST);
+	DynamicResolution::EndFrame(commands);
+}
+
 static inline void ErrorCallback(int _error, const char* _description)
 {
 	Print("Error: %s\n");
@@ -60,7 +188,10 @@ static inline void MouseButtonCallback(GLFWwindow* _renderWindow, int _button, i
 {
 	if (_action == GLFW_PRESS)
 	{
-		FrameBuffer::GrabIDUnderMouse(std::move(MouseX), std::move(MouseY));
+		// Read back once the next frame has been replayed
+		IsPickRequested = true;
+		PickX = MouseX;
+		PickY = MouseY;
 	}
 	else if (_action == GLFW_RELEASE)
 	{
@@ -80,6 +211,14 @@ static inline void KeyCallback(GLFWwindow* _renderWindow, int _key, int _scanCod
 		SceneCamera->Input();
 }
 
+static inline void WindowSizeCallback(GLFWwindow* _renderWindow, int _width, int _height)
+{
+	// Attachments, mouse picks and the composite viewport follow the window, the view keeps its height
+	FrameBuffer::SetWindowSize({ _width, _height });
+	if (SceneCamera && _width > 0 && _height > 0)
+		SceneCamera->SetAspect((float)_width / _height);
+}
+
 static inline void ScrollCallback(GLFWwindow* _renderWindow, double _xOffset, double _yOffset)
 {
 	if (SceneCamera)
@@ -114,6 +253,7 @@ void InitGLFW()
 	glfwSetCursorPosCallback(RenderWindow, CursorPositionCallback);
 	glfwSetMouseButtonCallback(RenderWindow, MouseButtonCallback);
 	glfwSetScrollCallback(RenderWindow, ScrollCallback);
+	glfwSetWindowSizeCallback(RenderWindow, WindowSizeCallback);
 
 	if (IsMouseActive)
 		glfwSetInputMode(RenderWindow, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -140,33 +280,94 @@ void Start()
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	FrameAllocator::Init();
+	JobSystem::Init();
+
+	// Attachments Are Sized From The Window
+	glm::ivec2 windowSize;
+	glfwGetWindowSize(RenderWindow, &windowSize.x, &windowSize.y);
+	FrameBuffer::SetWindowSize(windowSize);
+
 	FrameBuffer::InitFrameBufferDSA();
+	OverdrawAnalysis::Init(FrameBuffer::GetMaxSize().x, FrameBuffer::GetMaxSize().y);
+	DynamicResolution::Init();
 
 	TextureLoader::Init();
+	GeometryRegistry::Init();
+	AnimationLibrary::Init();
 
 	// Set Clear Color / Background
 	glClearColor(FrameBuffer::BackgroundColor[0], FrameBuffer::BackgroundColor[1], FrameBuffer::BackgroundColor[2], FrameBuffer::BackgroundColor[3]);
 
 	FrameBufferMesh = new Mesh(FrameBuffer::FrameBufferTexture);
-	
-	SceneCamera = new Camera(Keypresses);
 
-	for (int i = 0; i < 1; i++)
+	// Post Process Chain, All Off Until Toggled
+	PostProcess::Init();
 	{
-		Meshes.push_back(new Mesh(*SceneCamera, DeltaTime));
+		PostEffect blur{ PostEffectType::Blur, "Blur", false };
+		blur.Radius = 12.0f;
+		BlurEffect = PostProcess::AddEffect(blur);
+
+		PostEffect grade{ PostEffectType::ColorGrade, "ColorGrade", false };
+		grade.Grade = { 1.05f, 1.2f, 1.1f };
+		GradeEffect = PostProcess::AddEffect(grade);
+
+		PostEffect vignette{ PostEffectType::Vignette, "Vignette", false };
+		vignette.VignetteShape = { 0.5f, 0.6f };
+		VignetteEffect = PostProcess::AddEffect(vignette);
 	}
+	
+	SceneCamera = new Camera(Keypresses);
+	SceneCamera->SetAspect((float)FrameBuffer::GetWindowSize().x / FrameBuffer::GetWindowSize().y);
+
+	if (Benchmark::IsEnabled)
+		Benchmark::RunAll();
+
+	SceneBatch = new SpriteBatch(*SceneCamera);
+
+	// Capguy_Walk.png is a single row of 8 walk frames
+	TextureLayer capguy = TextureLoader::LoadTextureLayer("Resources/Textures/Capguy_Walk.png");
+	SpriteSheet capguySheet = SpriteSheet::Load(capguy.FilePath, 8, 1, 0.1f);
+	unsigned walk = AnimationLibrary::AddSheetClip(capguySheet, 0, capguySheet.GetFrameCount(), LoopMode::Loop, capguy.UVScale);
+	glm::vec2 capguySize = capguySheet.GetFrameSize();
+	Entity player = Registry.Create();
+	Registry.m_Transforms.Add(player.Index, 0.0f, 0.0f, 0.0f, capguySize.x, capguySize.y);
+	Registry.m_Sprites.Add(player.Index, { capguy.ArrayID, { 0.0f, 0.0f, 1.0f, 1.0f }, 0xFFFFFFFF, capguy.Layer, capguy.UVScale });
+	Registry.m_Animations.Add(player.Index, { walk, glfwGetTime() });
+	Registry.m_PickIDs.Add(player.Index, { 1 });
+
+	// Half Size Companion Parented To The Player, Offset In The Player's Unit Quad
+	Entity companion = Registry.Create();
+	Registry.m_Transforms.Add(companion.Index, 0.0f, 0.0f);
+	Registry.m_Sprites.Add(companion.Index, { capguy.ArrayID, { 0.0f, 0.0f, 1.0f, 1.0f }, 0xFFFFFFFF, capguy.Layer, capguy.UVScale });
+	Registry.m_Animations.Add(companion.Index, { walk, glfwGetTime(), 1.5f });
+	Registry.m_PickIDs.Add(companion.Index, { 2 });
+	Registry.m_HierarchyNodes.Add(companion.Index, { Registry.m_Hierarchy.AddNode({ 0.5f, 0.0f, 0.0f, 0.5f, 0.75f, -0.25f }), player });
+
+	if (Benchmark::IsEnabled)
+		Benchmark::SpawnWalkers(Registry, capguy, walk, capguySize);
+
+	// Systems, Run In Parallel Where Their Data Does Not Overlap
+	FrameGraph.AddSystem("Camera", Resource::Input, Resource::Camera | Resource::Transforms, CameraSystem);
+	FrameGraph.AddSystem("UpdateTransforms", Resource::None, Resource::Transforms, TransformSystem);
+	FrameGraph.AddSystem("UpdateHierarchy", Resource::None, Resource::Hierarchy | Resource::Transforms, HierarchySystem);
+	FrameGraph.AddSystem("Cull", Resource::Transforms | Resource::Camera, Resource::VisibleSprites, CullSystem);
+	FrameGraph.AddSystem("Render", Resource::Transforms | Resource::Sprites | Resource::Animations | Resource::PickIDs | Resource::VisibleSprites | Resource::Camera,
+		Resource::Input | Resource::Commands, RenderSystem);
+	FrameGraph.AddSystem("Composite", Resource::None, Resource::Commands, CompositeSystem);
+
+	// GL Context Moves To The Render Thread From Here
+	RenderThread::Start(RenderWindow);
 }
 
 void Update()
 {
 	while (!glfwWindowShouldClose(RenderWindow))
 	{
-		FrameBuffer::Bind();
-
-		// Clear Frame Buffer
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		FrameAllocator::Reset();
+		size_t allocations = FrameAllocator::GetAllocationCount();
 
-		FrameBuffer::ClearTexturesCustom();
+		FrameCommands = &RenderThread::BeginFrame();
 
 		// Update
 		for (auto& item : Keypresses)
@@ -194,6 +395,91 @@ void Update()
 					item.second = false;
 					break;
 				}
+				case GLFW_KEY_F1:
+				{
+					IsTraceRequested = true;
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F2:
+				{
+					SceneBatch->SetGPUCulling(!SceneBatch->IsGPUCulling());
+					Print(SceneBatch->IsGPUCulling() ? "GPU Culling" : "CPU Culling");
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F3:
+				{
+					SceneBatch->SetTightMeshes(!SceneBatch->IsTightMeshes());
+					Print(SceneBatch->IsTightMeshes() ? "Tight Sprite Meshes" : "Sprite Quads");
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F4:
+				{
+					OverdrawAnalysis::SetEnabled(!OverdrawAnalysis::IsEnabled());
+					Print(OverdrawAnalysis::IsEnabled() ? "Overdraw Heatmap" : "Overdraw Off");
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F5:
+				{
+					DynamicResolution::SetEnabled(!DynamicResolution::IsEnabled());
+					glm::ivec2 renderSize = FrameBuffer::GetRenderSize();
+					Print(FrameAllocator::Format("Dynamic Resolution %s : %dx%d at %.2fms GPU", DynamicResolution::IsEnabled() ? "On" : "Off",
+						renderSize.x, renderSize.y, DynamicResolution::GetGPUTime()));
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F6:
+				{
+					// Only the render resolution changes, the view keeps its height and snaps to whole virtual pixels
+					FrameBuffer::SetPixelPerfect(!FrameBuffer::IsPixelPerfect());
+					bool isPixelPerfect = FrameBuffer::IsPixelPerfect();
+					if (isPixelPerfect)
+					{
+						glm::ivec2 virtualSize = FrameBuffer::GetVirtualSize();
+						PixelPerfectViewSize = SceneCamera->GetViewSize();
+						SceneCamera->SetAspect((float)virtualSize.x / virtualSize.y);
+						SceneCamera->SetTexelSnap(SceneCamera->GetViewSize().y / virtualSize.y);
+					}
+					else
+					{
+						// The window may have been resized meanwhile
+						SceneCamera->SetViewSize(PixelPerfectViewSize);
+						SceneCamera->SetAspect((float)FrameBuffer::GetWindowSize().x / FrameBuffer::GetWindowSize().y);
+						SceneCamera->SetTexelSnap(0.0f);
+					}
+					glm::ivec2 renderSize = FrameBuffer::GetRenderSize();
+					Print(isPixelPerfect ? FrameAllocator::Format("Pixel Perfect : %dx%d x%d", renderSize.x, renderSize.y, FrameBuffer::GetUpscaleFactor()) : "Pixel Perfect Off");
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F7:
+				{
+					PostEffect& blur = PostProcess::GetEffect(BlurEffect);
+					blur.IsEnabled = !blur.IsEnabled;
+					Print(FrameAllocator::Format("Blur %s, Radius %.0f", blur.IsEnabled ? "On" : "Off", blur.Radius));
+
+					item.second = false;
+					break;
+				}
+				case GLFW_KEY_F8:
+				{
+					PostEffect& grade = PostProcess::GetEffect(GradeEffect);
+					grade.IsEnabled = !grade.IsEnabled;
+					PostProcess::GetEffect(VignetteEffect).IsEnabled = grade.IsEnabled;
+					Print(grade.IsEnabled ? "Color Grade And Vignette" : "Color Grade And Vignette Off");
+
+					item.second = false;
+					break;
+				}
 				default:
 					break;
 				}
@@ -201,58 +487,68 @@ void Update()
 		}
 
 		CalculateDeltaTime();
+		DynamicResolution::Update();
 
-		if (SceneCamera)
-		{
-			SceneCamera->Movement(DeltaTime);
-		}
+		// Run Frame Systems
+		VisibleSprites = FrameAllocator::AllocateList<unsigned>(Registry.m_Transforms.Size());
+		FrameGraph.Execute();
 
-		// Draw Items To Frame Buffer
-		for (auto& item : Meshes)
+		if (IsTraceRequested)
 		{
-			item->Draw();
+			FrameGraph.WriteTrace("FrameTrace.json");
+			FrameGraph.PrintSchedule();
+			CompositeGraph.PrintPasses();
+			IsTraceRequested = false;
 		}
-		
-		// Draw Frame Buffer To Screen
-		glDisable(GL_DEPTH_TEST);
-
-		FrameBuffer::UnBind();
-
-		if (FrameBufferMesh != nullptr)
-			FrameBufferMesh->Draw();
 
-		glEnable(GL_DEPTH_TEST);
+		// Replay And Swap Buffers
+		RenderThread::SubmitFrame();
+		OverdrawAnalysis::Report();
+		PostProcess::Report();
+		CompositeGraph.Report();
 
-		// Swap Buffers
-		glfwSwapBuffers(RenderWindow);
+		if (Benchmark::IsEnabled)
+			Benchmark::RenderThreadOverlap(SceneBatch->GetUploadBytes(), SceneBatch->IsGPUCulling());
 
 		// Poll Events
 		glfwPollEvents();
+
+		// Zero Allocation Check (counts are only collected in debug builds)
+		allocations = FrameAllocator::GetAllocationCount() - allocations;
+		if (allocations > 0 && FrameCounter > AllocationWarmupFrames)
+		{
+			Print(FrameAllocator::Format("Frame %u made %zu heap allocations", FrameCounter, allocations));
+			assert(!AssertOnFrameAllocation);
+		}
 	}
 }
 
 int Cleanup()
 {
+	RenderThread::Stop();
+	JobSystem::Shutdown();
+
 	FrameBuffer::Cleanup();
+	OverdrawAnalysis::Shutdown();
+	DynamicResolution::Shutdown();
+	PostProcess::Shutdown();
+	CompositeGraph.Release();
 
 	if (FrameBufferMesh != nullptr)
 		delete FrameBufferMesh;
 	FrameBufferMesh = nullptr;
 
-	for (auto& item : Meshes)
-	{
-		if (item != nullptr)
-		{
-			delete item;
-		}
-		item = nullptr;
-	}
-	Meshes.clear();
+	if (SceneBatch != nullptr)
+		delete SceneBatch;
+	SceneBatch = nullptr;
 
 	if (SceneCamera != nullptr)
 		delete SceneCamera;
 	SceneCamera = nullptr;
 
+	AnimationLibrary::Shutdown();
+	GeometryRegistry::Shutdown();
+
 	// Cleanup GLFW
 	glfwDestroyWindow(RenderWindow);
 	glfwTerminate();
@@ -5,11 +5,11 @@ Mesh::Mesh(GLuint _textureID)
 	Init(_textureID);
 }
 
-Mesh::Mesh(Camera& _camera, double& _deltaTime)
+Mesh::Mesh(Camera& _camera, double& _deltaTime, const Texture& _texture, int _clip, const glm::vec2& _frameSize)
 {
 	m_Camera = &_camera;
 	m_DeltaTime = &_deltaTime;
-	Init();
+	Init(_texture, _clip, _frameSize);
 }
 
 Mesh::~Mesh()
@@ -17,17 +17,13 @@ Mesh::~Mesh()
 	// Unbind
 	{
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindVertexArray(0);
 		glUseProgram(0);
 	}
-	// Delete
+	// Delete, Geometry Belongs To The GeometryRegistry
 	{
-		glDeleteBuffers(1, &UniformBufferID);
-		glDeleteVertexArrays(1, &VertexArrayID);
-		glDeleteBuffers(1, &VertBufferID);
-		glDeleteBuffers(1, &IndexBufferID);
+		if (UniformBufferID != 0)
+			glDeleteBuffers(1, &UniformBufferID);
 		//glDeleteProgram(ShaderID);
 	}
 	m_Camera = nullptr;
@@ -49,37 +45,22 @@ void Mesh::Init(GLuint _screenTextureID)
 	ShaderID = ShaderLoader::CreateShader("Resources/Shaders/frameBuffer.vert", "Resources/Shaders/frameBuffer.frag");
 	glUseProgram(ShaderID);
 
-	// Vertex Array
-	glGenVertexArrays(1, &VertexArrayID);
-	glBindVertexArray(VertexArrayID);
-
-	// Vertex Buffer
-	glGenBuffers(1, &VertBufferID);
-	glBindBuffer(GL_ARRAY_BUFFER, VertBufferID);
-	glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex), &m_Vertices[0], GL_STATIC_DRAW);
-
-	// Index Buffer
-	glGenBuffers(1, &IndexBufferID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBufferID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(unsigned int), &m_Indices[0], GL_STATIC_DRAW);
-	
-	// Layouts
-	glBindBuffer(GL_ARRAY_BUFFER, VertBufferID);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, texCoords)));
+	// Geometry
+	m_Geometry = GeometryRegistry::Add(m_Vertices, m_Indices);
 	
 	glUniform1i(glGetUniformLocation(ShaderID, "screenTexture"), 0);
+	glUniform1i(glGetUniformLocation(ShaderID, "OverdrawCounts"), OverdrawAnalysis::TextureUnit);
+	OverdrawLocation = glGetUniformLocation(ShaderID, "Overdraw");
+	HeatmapScaleLocation = glGetUniformLocation(ShaderID, "HeatmapScale");
+	RenderScaleLocation = glGetUniformLocation(ShaderID, "RenderScale");
+	UpscaleFactorLocation = glGetUniformLocation(ShaderID, "UpscaleFactor");
+	UpscaleOffsetLocation = glGetUniformLocation(ShaderID, "UpscaleOffset");
 
 	// Unbind
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
 	glUseProgram(0);
 }
 
-void Mesh::Init()
+void Mesh::Init(const Texture& _texture, int _clip, const glm::vec2& _frameSize)
 {
 	// Indices
 	GenerateQuadIndices();
@@ -90,32 +71,19 @@ void Mesh::Init()
 	m_Vertices.push_back({ glm::vec3{ 0.5f,  -0.5f, 0.0f}, glm::vec2{1.0f,0.0f} }); // Bottom Right
 	m_Vertices.push_back({ glm::vec3{ 0.5f,   0.5f, 0.0f}, glm::vec2{1.0f,1.0f} }); // Top Right
 	
-	m_ActiveTextures.emplace_back(TextureLoader::LoadTexture("Resources/Textures/Capguy_Walk.png"));
+	m_ActiveTextures.push_back(_texture);
 
 	// Shader
 	ShaderID = ShaderLoader::CreateShader("Resources/Shaders/basic.vert", "Resources/Shaders/basic.frag");
 	glUseProgram(ShaderID);
 
-	// Vertex Array
-	glGenVertexArrays(1, &VertexArrayID);
-	glBindVertexArray(VertexArrayID);
-
-	// Vertex Buffer
-	glGenBuffers(1, &VertBufferID);
-	glBindBuffer(GL_ARRAY_BUFFER, VertBufferID);
-	glBufferData(GL_ARRAY_BUFFER, m_Vertices.size() * sizeof(Vertex), m_Vertices.data(), GL_STATIC_DRAW);
-
-	// Index Buffer
-	glGenBuffers(1, &IndexBufferID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBufferID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Indices.size() * sizeof(unsigned int), m_Indices.data(), GL_STATIC_DRAW);
+	// Geometry
+	m_Geometry = GeometryRegistry::Add(m_Vertices, m_Indices);
 
-	// Layouts
-	glBindBuffer(GL_ARRAY_BUFFER, VertBufferID);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, texCoords)));
+	// Flipbook, The Caller Owns The Clip
+	m_Clip = _clip;
+	m_ClipStart = glfwGetTime();
+	m_FrameSize = _frameSize;
 
 	// Uniform Buffer
 	glGenBuffers(1, &UniformBufferID);
@@ -126,19 +94,42 @@ void Mesh::Init()
 	glBindBufferRange(GL_UNIFORM_BUFFER, matrixBlockIndex, UniformBufferID, 0, 2 * sizeof(glm::mat4));
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
+	// Uniforms
+	ModelLocation = glGetUniformLocation(ShaderID, "Model");
+	TimeLocation = glGetUniformLocation(ShaderID, "Time");
+	IdLocation = glGetUniformLocation(ShaderID, "Id");
+	ClipLocation = glGetUniformLocation(ShaderID, "Clip");
+	ClipStartLocation = glGetUniformLocation(ShaderID, "ClipStart");
+	ClipSpeedLocation = glGetUniformLocation(ShaderID, "ClipSpeed");
+	OverdrawLocation = glGetUniformLocation(ShaderID, "Overdraw");
+	glUniform1i(glGetUniformLocation(ShaderID, "Diffuse"), 0);
+
 	// Unbind
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	glUseProgram(0);
 }
 
 void Mesh::Draw()
+{
+	m_Commands.Reset();
+	Record(m_Commands);
+	m_Commands.Execute();
+}
+
+void Mesh::Record(CommandBuffer& _commands)
 {
 	// Bind
-	glUseProgram(ShaderID);
-	glBindVertexArray(VertexArrayID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBufferID);
+	_commands.UseProgram(ShaderID);
+	_commands.BindVertexArray(m_Geometry.VertexArrayID);
+	_commands.Uniform1i(OverdrawLocation, OverdrawAnalysis::IsEnabled());
+	if (HeatmapScaleLocation != -1)
+		_commands.Uniform1f(HeatmapScaleLocation, OverdrawAnalysis::HeatmapScale);
+	if (RenderScaleLocation != -1)
+	{
+		int upscaleFactor = FrameBuffer::GetUpscaleFactor();
+		_commands.Uniform2f(RenderScaleLocation, FrameBuffer::GetRenderScale());
+		_commands.Uniform1i(UpscaleFactorLocation, upscaleFactor);
+		_commands.Uniform2f(UpscaleOffsetLocation, FrameBuffer::GetUpscaleOffset(FrameBuffer::GetWindowSize(), FrameBuffer::GetRenderSize(), upscaleFactor));
+	}
 
 	// If Not Frame Buffer
 	if (m_Camera)
@@ -146,73 +137,65 @@ void Mesh::Draw()
 		ProjectionMat = m_Camera->GetProjectionMatrix();
 		ViewMat = m_Camera->GetViewMatrix();
 
-		float time = glfwGetTime();
+		double time = glfwGetTime();
 		//m_Transform.scale = { ((sin(time) / 2) + 0.5f) ,((sin(time) / 2) + 0.5f) ,((sin(time) / 2) + 0.5f) };
 		//m_Transform.rotation_axis = { ((sin(time)) + 0.5f) ,((sin(time) / 2) + 0.5f) ,((sin(time) / 4) + 0.5f) };
 		//m_Transform.rotation_value = ((sin(time * 5)) + 0.5f);
 
 		ScaleToTexture();
 		{
-			// Bind
-			glBindBuffer(GL_UNIFORM_BUFFER, UniformBufferID);
 			// Stream In Proj Mat
-			glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), &ProjectionMat[0]);
+			_commands.BufferSubData(UniformBufferID, 0, sizeof(glm::mat4), &ProjectionMat[0]);
 			// Stream In View Mat
-			glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), sizeof(glm::mat4), &ViewMat[0]);
-			// Unbind
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
-		}
-
-		if (m_Animated)
-		{
-			for (auto& item : m_Vertices)
-			{
-				if (item.texCoords.x > 0)
-				{
-					item.texCoords.x = 0.25f;
-				}
-			}
-
-			glBindBuffer(GL_ARRAY_BUFFER, VertBufferID);
-			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex), m_Vertices.data());
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			_commands.BufferSubData(UniformBufferID, sizeof(glm::mat4), sizeof(glm::mat4), &ViewMat[0]);
 		}
 
-		ShaderLoader::SetUniformMatrix4fv(ShaderID, "Model", m_Transform.tranform);
-		ShaderLoader::SetUniform1f(ShaderID, "Time", time);
-		ShaderLoader::SetUniform1i(ShaderID, "Id", m_ObjectID);
+		_commands.UniformMatrix4fv(ModelLocation, m_Transform.tranform);
+		_commands.Uniform1f(TimeLocation, AnimationLibrary::ToShaderTime(time));
+		_commands.Uniform1i(IdLocation, m_ObjectID);
+		_commands.Uniform1i(ClipLocation, m_Clip);
+		_commands.Uniform1f(ClipStartLocation, AnimationLibrary::ToShaderTime(m_ClipStart));
+		_commands.Uniform1f(ClipSpeedLocation, m_ClipSpeed);
+		AnimationLibrary::Flush(_commands);
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, m_ActiveTextures[0].ID);
-		ShaderLoader::SetUniform1i(ShaderID, "Diffuse", 0);
+		_commands.BindTextureUnit(0, m_ActiveTextures[0].ID);
 	}
 
 	// Draw
-	glDrawElements(GL_TRIANGLES, m_Indices.size(), GL_UNSIGNED_INT, nullptr);
+	_commands.DrawElementsBaseVertex(GL_TRIANGLES, m_Geometry.IndexCount, m_Geometry.FirstIndex, m_Geometry.BaseVertex);
 
 	// Unbind
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glUseProgram(0);
+	_commands.BindTextureUnit(0, 0);
+	_commands.BindVertexArray(0);
+	_commands.UseProgram(0);
+}
+
+const VertexLayout& Mesh::GetVertexLayout()
+{
+	static const VertexLayout layout = VertexLayout(sizeof(Vertex))
+		.Add(0, AttributeFormat::Snorm16x2, offsetof(Vertex, position))
+		.Add(1, AttributeFormat::Unorm16x2, offsetof(Vertex, texCoords));
+	return layout;
 }
 
 void Mesh::GenerateQuadIndices(int _numberOfQuads)
 {
 	for (int i = 0; i < _numberOfQuads; i++)
 	{
-		m_Indices.push_back(0 + (3 * i));
-		m_Indices.push_back(1 + (3 * i));
-		m_Indices.push_back(2 + (3 * i));
+		m_Indices.push_back(0 + (4 * i));
+		m_Indices.push_back(1 + (4 * i));
+		m_Indices.push_back(2 + (4 * i));
 
-		m_Indices.push_back(0 + (3 * i));
-		m_Indices.push_back(2 + (3 * i));
-		m_Indices.push_back(3 + (3 * i));
+		m_Indices.push_back(0 + (4 * i));
+		m_Indices.push_back(2 + (4 * i));
+		m_Indices.push_back(3 + (4 * i));
 	}
 }
 
 void Mesh::ScaleToTexture()
 {
-	m_Transform.scale = { m_ActiveTextures[0].Dimensions.x / 2,m_ActiveTextures[0].Dimensions.y/2,0};
-	UpdateModelValueOfTransform(m_Transform);
+	// One frame of the sheet, not the whole sheet
+	glm::vec2 size = m_FrameSize.x > 0.0f ? m_FrameSize : m_ActiveTextures[0].Dimensions;
+	m_Transform.scale = { size.x / 2, size.y / 2, 0 };
+	UpdateModelValueOfTransform(m_Transform, m_Camera ? m_Camera->GetOrigin() : glm::dvec3(0));
 }
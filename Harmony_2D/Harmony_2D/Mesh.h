@@ -2,26 +2,50 @@
 #include "ShaderLoader.h"
 #include "Camera.h"
 #include "TextureLoader.h"
+#include "CommandBuffer.h"
+#include "GeometryRegistry.h"
+#include "AnimationLibrary.h"
+#include "OverdrawAnalysis.h"
+#include "FrameBuffer.h"
 
 class Mesh
 {
 public:
 	Mesh(GLuint _textureID);
-	Mesh(Camera& _camera, double& _deltaTime);
+	// _clip is an AnimationLibrary clip played over _texture, -1 for a still image. _frameSize is what
+	// the quad scales to, the texture's size when zero
+	Mesh(Camera& _camera, double& _deltaTime, const Texture& _texture, int _clip = -1, const glm::vec2& _frameSize = glm::vec2(0.0f));
 	~Mesh();
 	void Init(GLuint _screenTextureID);
-	void Init();
+	void Init(const Texture& _texture, int _clip, const glm::vec2& _frameSize);
 	void Draw();
+	// Records the draw without touching GL, Draw() replays it immediately
+	void Record(CommandBuffer& _commands);
 
 	inline Transform& GetTransform() { return m_Transform; }
+	static const VertexLayout& GetVertexLayout();
 private:
 	GLuint ShaderID;
-	GLuint VertBufferID;
-	GLuint IndexBufferID;
-	GLuint VertexArrayID;
-	GLuint UniformBufferID;
+	GLuint UniformBufferID = 0;
+	Geometry m_Geometry;
+	GLint ModelLocation = -1;
+	GLint TimeLocation = -1;
+	GLint IdLocation = -1;
+	GLint ClipLocation = -1;
+	GLint ClipStartLocation = -1;
+	GLint ClipSpeedLocation = -1;
+	GLint OverdrawLocation = -1;
+	GLint HeatmapScaleLocation = -1;
+	GLint RenderScaleLocation = -1;
+	GLint UpscaleFactorLocation = -1;
+	GLint UpscaleOffsetLocation = -1;
 	int m_ObjectID = 1;
-	bool m_Animated = true;
+
+	// Flipbook played by basic.vert, -1 for a still image
+	int m_Clip = -1;
+	double m_ClipStart = 0.0;
+	float m_ClipSpeed = 1.0f;
+	glm::vec2 m_FrameSize{ 0.0f };
 	double* m_DeltaTime = nullptr;
 
 	glm::mat4 ProjectionMat;
@@ -32,6 +56,7 @@ private:
 	std::vector<Texture> m_ActiveTextures;
 
 	Camera* m_Camera = nullptr;
+	CommandBuffer m_Commands;
 
 	Transform m_Transform;
 
@@ -0,0 +1,166 @@
+#include "OverdrawAnalysis.h"
+#include "FrameBuffer.h"
+
+void OverdrawAnalysis::Init(GLsizei _width, GLsizei _height)
+{
+	glCreateTextures(GL_TEXTURE_2D, 1, &CountTextureID);
+	glTextureParameteri(CountTextureID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(CountTextureID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(CountTextureID, GL_TEXTURE_MAX_LEVEL, 0);
+	Resize(_width, _height);
+
+	// Core since 4.6, the ARB extension before that
+	m_HasPipelineStatistics = GLEW_VERSION_4_6 || GLEW_ARB_pipeline_statistics_query;
+	if (m_HasPipelineStatistics)
+		glCreateQueries(GL_FRAGMENT_SHADER_INVOCATIONS, (GLsizei)OverdrawPass::Count, QueryIDs);
+	else
+		Print("Overdraw : no pipeline statistics queries, reporting counts only");
+}
+
+void OverdrawAnalysis::Shutdown()
+{
+	glDeleteTextures(1, &CountTextureID);
+	CountTextureID = 0;
+	if (m_HasPipelineStatistics)
+		glDeleteQueries((GLsizei)OverdrawPass::Count, QueryIDs);
+
+	m_Counts.clear();
+	m_Counts.shrink_to_fit();
+	m_Width = m_Height = 0;
+}
+
+void OverdrawAnalysis::Resize(GLsizei _width, GLsizei _height)
+{
+	m_Width = _width;
+	m_Height = _height;
+	m_Counts.resize((size_t)_width * _height);
+
+	// Mutable storage so the name survives a resize, the composite imports it
+	glBindTexture(GL_TEXTURE_2D, CountTextureID);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, _width, _height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OverdrawAnalysis::BeginFrame(CommandBuffer& _commands)
+{
+	if (!m_IsEnabled)
+		return;
+	glm::ivec2 size = FrameBuffer::GetMaxSize();
+	_commands.Callback(ClearCounts, &size, sizeof(size));
+}
+
+void OverdrawAnalysis::BeginPass(CommandBuffer& _commands, OverdrawPass _pass)
+{
+	if (!m_IsEnabled || !m_HasPipelineStatistics)
+		return;
+	_commands.Callback(BeginQuery, &_pass, sizeof(_pass));
+}
+
+void OverdrawAnalysis::EndPass(CommandBuffer& _commands, OverdrawPass _pass)
+{
+	if (!m_IsEnabled || !m_HasPipelineStatistics)
+		return;
+	_commands.Callback(EndQuery, &_pass, sizeof(_pass));
+}
+
+void OverdrawAnalysis::ResolveCounts(CommandBuffer& _commands)
+{
+	if (!m_IsEnabled)
+		return;
+	_commands.Callback([](const void*) { glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT); }, nullptr, 0);
+	_commands.BindTextureUnit(TextureUnit, CountTextureID);
+}
+
+void OverdrawAnalysis::EndFrame(CommandBuffer& _commands)
+{
+	if (!m_IsEnabled)
+		return;
+	_commands.BindTextureUnit(TextureUnit, 0);
+	glm::ivec2 renderSize = FrameBuffer::GetRenderSize();
+	_commands.Callback(ReadBack, &renderSize, sizeof(renderSize));
+}
+
+void OverdrawAnalysis::Report()
+{
+	if (!m_HasNewStats.exchange(false))
+		return;
+
+	OverdrawStats stats = GetStats();
+	Print(FrameAllocator::Format("Overdraw (%dx%d) : mean %.2f | covered mean %.2f over %.1f%% of pixels | max %u",
+		stats.Size.x, stats.Size.y, stats.Mean, stats.CoveredMean, stats.Covered * 100.0, stats.Max));
+	if (m_HasPipelineStatistics)
+	{
+		double pixels = (double)stats.Size.x * stats.Size.y;
+		Print(FrameAllocator::Format("  Fragment Invocations : Scene %llu (%.2f per pixel) | Composite %llu (%.2f per pixel)",
+			(unsigned long long)stats.Invocations[(unsigned)OverdrawPass::Scene], stats.Invocations[(unsigned)OverdrawPass::Scene] / pixels,
+			(unsigned long long)stats.Invocations[(unsigned)OverdrawPass::Composite], stats.Invocations[(unsigned)OverdrawPass::Composite] / pixels));
+	}
+}
+
+OverdrawStats OverdrawAnalysis::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_StatsMutex);
+	return m_Stats;
+}
+
+void OverdrawAnalysis::ClearCounts(const void* _payload)
+{
+	const glm::ivec2& size = *static_cast<const glm::ivec2*>(_payload);
+	if (size.x != m_Width || size.y != m_Height)
+		Resize(size.x, size.y);
+
+	const GLuint zero = 0;
+	glClearTexImage(CountTextureID, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+	glBindImageTexture(ImageUnit, CountTextureID, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+}
+
+void OverdrawAnalysis::BeginQuery(const void* _payload)
+{
+	OverdrawPass pass = *static_cast<const OverdrawPass*>(_payload);
+	glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS, QueryIDs[(unsigned)pass]);
+}
+
+void OverdrawAnalysis::EndQuery(const void*)
+{
+	glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS);
+}
+
+void OverdrawAnalysis::ReadBack(const void* _payload)
+{
+	if (++m_Frame % ReportFrames != 0)
+		return;
+
+	// Stalls on this frame, fine for a diagnostic mode
+	glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+	glGetTextureImage(CountTextureID, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, (GLsizei)(m_Counts.size() * sizeof(GLuint)), m_Counts.data());
+
+	OverdrawStats stats;
+	stats.Frame = m_Frame;
+	stats.Size = *static_cast<const glm::ivec2*>(_payload);
+	unsigned long long total = 0;
+	size_t covered = 0;
+	for (int y = 0; y < stats.Size.y; y++)
+	{
+		const GLuint* row = m_Counts.data() + (size_t)y * m_Width;
+		for (int x = 0; x < stats.Size.x; x++)
+		{
+			total += row[x];
+			covered += row[x] > 0;
+			stats.Max = glm::max(stats.Max, row[x]);
+		}
+	}
+	size_t pixels = glm::max((size_t)stats.Size.x * stats.Size.y, (size_t)1);
+	stats.Mean = (double)total / pixels;
+	stats.CoveredMean = covered > 0 ? (double)total / covered : 0.0;
+	stats.Covered = (double)covered / pixels;
+
+	if (m_HasPipelineStatistics)
+	{
+		for (unsigned i = 0; i < (unsigned)OverdrawPass::Count; i++)
+			glGetQueryObjectui64v(QueryIDs[i], GL_QUERY_RESULT, &stats.Invocations[i]);
+	}
+
+	std::lock_guard<std::mutex> lock(m_StatsMutex);
+	m_Stats = stats;
+	m_HasNewStats.store(true);
+}
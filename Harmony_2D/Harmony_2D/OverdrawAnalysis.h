@@ -0,0 +1,83 @@
+#pragma once
+#include "FrameAllocator.h"
+#include "CommandBuffer.h"
+#include <atomic>
+#include <mutex>
+
+enum class OverdrawPass : unsigned
+{
+	Scene,
+	Composite,
+	Count
+};
+
+struct OverdrawStats
+{
+	unsigned Frame = 0;
+	glm::ivec2 Size{ 0 };      // render size the counts were taken over
+	double Mean = 0.0;        // fragments per pixel over the whole render size
+	double CoveredMean = 0.0; // fragments per pixel over pixels drawn at least once
+	GLuint Max = 0;
+	double Covered = 0.0;     // fraction of pixels drawn at least once
+	GLuint64 Invocations[(unsigned)OverdrawPass::Count] = {}; // fragment shader invocations, 0 without pipeline statistics
+};
+
+// Diagnostic mode counting how many fragments land on each pixel of the frame buffer. Fragment
+// shaders with an Overdraw uniform add 1 per fragment to an R32UI image, frameBuffer.frag shows
+// the counts as a heatmap and every ReportFrames frames the counts are read back for mean and max.
+// Where ARB_pipeline_statistics_query is available each pass also counts its fragment shader
+// invocations. Recording happens on the simulation thread, the GL work runs in callbacks on the
+// render thread and Report() prints the latest results from the simulation thread.
+static class OverdrawAnalysis
+{
+public:
+	// Sized like the frame buffer attachments, BeginFrame resizes them along with FrameBuffer::GetMaxSize
+	static void Init(GLsizei _width, GLsizei _height);
+	static void Shutdown();
+
+	inline static bool IsEnabled() { return m_IsEnabled; }
+	inline static void SetEnabled(bool _enabled) { m_IsEnabled = _enabled; }
+	inline static GLuint GetCountTexture() { return CountTextureID; }
+
+	// Clears the counts and binds them for the frame's fragment shaders
+	static void BeginFrame(CommandBuffer& _commands);
+	static void BeginPass(CommandBuffer& _commands, OverdrawPass _pass);
+	static void EndPass(CommandBuffer& _commands, OverdrawPass _pass);
+	// Makes the counts visible to frameBuffer.frag, call before the composite
+	static void ResolveCounts(CommandBuffer& _commands);
+	// Reads the counts and queries back every ReportFrames frames, call after the composite.
+	// Only the frame's render size (FrameBuffer::GetRenderSize) is counted
+	static void EndFrame(CommandBuffer& _commands);
+
+	// Prints the latest stats if the render thread produced new ones
+	static void Report();
+	static OverdrawStats GetStats();
+
+	static const GLuint ImageUnit = 0;
+	static const GLuint TextureUnit = 1;
+	static const unsigned ReportFrames = 120;
+	// Counts mapped to the top of the heatmap
+	inline static float HeatmapScale = 8.0f;
+
+private:
+	static void Resize(GLsizei _width, GLsizei _height);
+	static void ClearCounts(const void* _payload);
+	static void BeginQuery(const void* _payload);
+	static void EndQuery(const void* _payload);
+	static void ReadBack(const void* _payload);
+
+	inline static GLuint CountTextureID = 0;
+	inline static GLuint QueryIDs[(unsigned)OverdrawPass::Count] = {};
+	inline static bool m_IsEnabled = false;
+	inline static bool m_HasPipelineStatistics = false;
+
+	// Render Thread
+	inline static GLsizei m_Width = 0;
+	inline static GLsizei m_Height = 0;
+	inline static unsigned m_Frame = 0;
+	inline static std::vector<GLuint> m_Counts;
+
+	inline static std::mutex m_StatsMutex;
+	inline static OverdrawStats m_Stats;
+	inline static std::atomic<bool> m_HasNewStats{ false };
+};
@@ -0,0 +1,453 @@
+#include "PostProcess.h"
+#include "OverdrawAnalysis.h"
+#include <algorithm>
+#include <cassert>
+
+void PostProcess::Init()
+{
+	// The composite program is shared with FrameBuffer's screen mesh, the fused passes draw the same
+	// fragment shader into a post target
+	CompositeShaderID = ShaderLoader::CreateShader("Resources/Shaders/frameBuffer.vert", "Resources/Shaders/frameBuffer.frag");
+	FusedShaderID = ShaderLoader::CreateShader("Resources/Shaders/postProcess.vert", "Resources/Shaders/frameBuffer.frag");
+	BlurShaderID = ShaderLoader::CreateShader("Resources/Shaders/postProcess.vert", "Resources/Shaders/blur.frag");
+	BlurComputeShaderID = ShaderLoader::CreateComputeShader("Resources/Shaders/blur.comp");
+
+	m_CompositeLocations = GetFusedLocations(CompositeShaderID);
+	m_FusedLocations = GetFusedLocations(FusedShaderID);
+	glProgramUniform1i(FusedShaderID, glGetUniformLocation(FusedShaderID, "screenTexture"), 0);
+	glProgramUniform1i(FusedShaderID, glGetUniformLocation(FusedShaderID, "OverdrawCounts"), OverdrawAnalysis::TextureUnit);
+
+	glProgramUniform1i(BlurShaderID, glGetUniformLocation(BlurShaderID, "Source"), 0);
+	BlurDirectionLocation = glGetUniformLocation(BlurShaderID, "Direction");
+	BlurRenderSizeLocation = glGetUniformLocation(BlurShaderID, "RenderSize");
+	BlurRadiusLocation = glGetUniformLocation(BlurShaderID, "Radius");
+	BlurWeightsLocation = glGetUniformLocation(BlurShaderID, "Weights");
+
+	glProgramUniform1i(BlurComputeShaderID, glGetUniformLocation(BlurComputeShaderID, "Source"), 0);
+	ComputeDirectionLocation = glGetUniformLocation(BlurComputeShaderID, "Direction");
+	ComputeRenderSizeLocation = glGetUniformLocation(BlurComputeShaderID, "RenderSize");
+	ComputeRadiusLocation = glGetUniformLocation(BlurComputeShaderID, "Radius");
+	ComputeWeightsLocation = glGetUniformLocation(BlurComputeShaderID, "Weights");
+
+	// Empty Vertex Array, Passes Draw One Full Screen Triangle
+	glCreateVertexArrays(1, &VertexArrayID);
+	glCreateQueries(GL_TIMESTAMP, QueryFrames * (MaxPasses + 1), &QueryIDs[0][0]);
+
+	m_Effects.reserve(MaxEffects);
+}
+
+void PostProcess::Shutdown()
+{
+	glDeleteQueries(QueryFrames * (MaxPasses + 1), &QueryIDs[0][0]);
+	glDeleteVertexArrays(1, &VertexArrayID);
+	VertexArrayID = 0;
+}
+
+unsigned PostProcess::AddEffect(const PostEffect& _effect)
+{
+	// Plans keep a bit per effect
+	assert(m_Effects.size() < MaxEffects);
+	m_Effects.push_back(_effect);
+	return (unsigned)m_Effects.size() - 1;
+}
+
+unsigned PostProcess::AddPasses(RenderGraph& _graph, CommandBuffer& _commands, unsigned _source)
+{
+	m_PassCount = Plan(m_Passes);
+
+	glm::ivec2 renderSize = FrameBuffer::GetRenderSize();
+	_commands.Callback(BeginTimer, &renderSize, sizeof(renderSize));
+
+	// Transients at the max size so their slots survive render size changes, the graph aliases
+	// each blur's scratch and every intermediate once its last reader has run
+	const RenderTargetDesc desc{ FrameBuffer::GetMaxSize(), GL_RGBA8 };
+
+	// Every pass but the composite, each writing a new target
+	unsigned result = _source;
+	for (unsigned i = 0; i + 1 < m_PassCount; i++)
+	{
+		PassPayload pass;
+		pass.Pass = m_Passes[i];
+		pass.Source = result;
+		pass.Direction = { 1, 0 };
+		pass.IsLast = pass.Pass.Kind == PostPassKind::Fused;
+		pass.RenderSize = renderSize;
+		pass.RenderScale = glm::vec2(renderSize) / glm::vec2(desc.Size);
+		pass.Fused = GetFusedUniforms(pass.Pass.Effects);
+		GaussianWeights(pass.Pass.Radius, pass.Weights);
+
+		pass.Target = _graph.CreateTransient(pass.IsLast ? "Post Target" : "Post Scratch", desc);
+		if (AddGraphPass(_graph, pass) == ~0u)
+			break;
+		if (!pass.IsLast)
+		{
+			// Second Direction Reads The First
+			pass.Source = pass.Target;
+			pass.Target = _graph.CreateTransient("Post Target", desc);
+			pass.Direction = { 0, 1 };
+			pass.IsLast = true;
+			if (AddGraphPass(_graph, pass) == ~0u)
+				break;
+		}
+		result = pass.Target;
+	}
+	return result;
+}
+
+void PostProcess::BeginComposite(RenderGraph& _graph, CommandBuffer& _commands, unsigned _result)
+{
+	_commands.Callback([](const void*)
+		{
+			glEnable(GL_BLEND);
+			glBindVertexArray(0);
+			glUseProgram(0);
+		});
+	_graph.BindTexture(_commands, 0, _result);
+
+	FusedUniforms composite = GetFusedUniforms(m_Passes[m_PassCount - 1].Effects);
+	_commands.Callback([](const void* _payload) { SetFusedUniforms(CompositeShaderID, m_CompositeLocations, *static_cast<const FusedUniforms*>(_payload)); },
+		&composite, sizeof(composite));
+}
+
+void PostProcess::EndFrame(CommandBuffer& _commands)
+{
+	PostPass composite = m_Passes[m_PassCount - 1];
+	_commands.Callback([](const void* _payload)
+		{
+			EndTimedPass(_payload);
+			m_IsPending[m_Slot] = true;
+		}, &composite, sizeof(composite));
+}
+
+void PostProcess::Report()
+{
+	if (++m_Frame % ReportFrames != 0 || !m_HasTimings.exchange(false))
+		return;
+
+	PassTiming timings[MaxPasses];
+	unsigned count = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_TimingMutex);
+		count = m_TimingCount;
+		std::copy(m_Timings, m_Timings + count, timings);
+	}
+
+	double total = 0.0;
+	for (unsigned i = 0; i < count; i++)
+		total += timings[i].Milliseconds;
+	Print(FrameAllocator::Format("PostProcess : %u passes, %.3fms", count, total));
+
+	static const char* kindNames[] = { "Fused", "Separable", "Compute" };
+	for (unsigned i = 0; i < count; i++)
+	{
+		const PostPass& pass = timings[i].Pass;
+		std::string_view names = "";
+		for (unsigned effect = 0; effect < m_Effects.size(); effect++)
+		{
+			if (pass.Effects & (1u << effect))
+				names = FrameAllocator::Format(names.empty() ? "%.*s%s" : "%.*s + %s", (int)names.size(), names.data(), m_Effects[effect].Name);
+		}
+		if (pass.Kind != PostPassKind::Fused)
+			names = FrameAllocator::Format("%.*s r%d", (int)names.size(), names.data(), pass.Radius);
+		Print(FrameAllocator::Format("  %s [%.*s] %.3fms", i + 1 == count ? "Composite" : kindNames[(unsigned)pass.Kind],
+			(int)names.size(), names.data(), timings[i].Milliseconds));
+	}
+}
+
+unsigned PostProcess::Plan(PostPass* _passes)
+{
+	unsigned count = 0;
+	PostPass fused;
+	int lastStage = -1;
+	for (unsigned i = 0; i < m_Effects.size(); i++)
+	{
+		const PostEffect& effect = m_Effects[i];
+		if (!effect.IsEnabled || IsNoOp(effect))
+			continue;
+
+		// Room for a flushed fused pass, a blur and the composite
+		if (count + 2 >= MaxPasses)
+			break;
+
+		int stage = GetStage(effect);
+		if (stage < 0)
+		{
+			// Blurs read everything before them, so that has to be drawn first
+			if (fused.Effects != 0)
+			{
+				_passes[count++] = fused;
+				fused = PostPass();
+				lastStage = -1;
+			}
+			int radius = glm::min((int)glm::round(effect.Radius), MaxComputeRadius);
+			_passes[count++] = { radius <= MaxSeparableRadius ? PostPassKind::Separable : PostPassKind::Compute, 1u << i, radius };
+			continue;
+		}
+
+		// frameBuffer.frag only runs its stages forward
+		if (stage <= lastStage)
+		{
+			_passes[count++] = fused;
+			fused = PostPass();
+		}
+		fused.Effects |= 1u << i;
+		lastStage = stage;
+	}
+
+	// The composite always runs, with whatever is left fused in
+	_passes[count++] = fused;
+	return count;
+}
+
+void PostProcess::GaussianWeights(int _radius, float* _weights)
+{
+	float sigma = glm::max(_radius * 0.5f, 0.5f);
+	float total = 0.0f;
+	for (int i = 0; i <= _radius; i++)
+	{
+		_weights[i] = glm::exp(-(float)(i * i) / (2.0f * sigma * sigma));
+		total += i == 0 ? _weights[i] : 2.0f * _weights[i];
+	}
+	for (int i = 0; i <= _radius; i++)
+		_weights[i] /= total;
+}
+
+bool PostProcess::IsNoOp(const PostEffect& _effect)
+{
+	switch (_effect.Type)
+	{
+	case PostEffectType::Convolution:
+	{
+		static const float identity[9] = { 0, 0, 0, 0, 1, 0, 0, 0, 0 };
+		return std::equal(_effect.Kernel, _effect.Kernel + 9, identity);
+	}
+	case PostEffectType::Blur:
+		return glm::round(_effect.Radius) < 1.0f;
+	case PostEffectType::ColorGrade:
+		return _effect.Grade == glm::vec3(1.0f);
+	case PostEffectType::Vignette:
+		return _effect.VignetteShape.y <= 0.0f;
+	default:
+		return false;
+	}
+}
+
+int PostProcess::GetStage(const PostEffect& _effect)
+{
+	switch (_effect.Type)
+	{
+	case PostEffectType::Convolution:
+		return 0;
+	case PostEffectType::Blur:
+		// Radius 1 is a 3x3 kernel
+		return glm::round(_effect.Radius) <= 1.0f ? 0 : -1;
+	case PostEffectType::ColorGrade:
+		return 1;
+	case PostEffectType::Vignette:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+PostProcess::FusedUniforms PostProcess::GetFusedUniforms(unsigned _effects)
+{
+	FusedUniforms uniforms;
+	for (unsigned i = 0; i < m_Effects.size(); i++)
+	{
+		if ((_effects & (1u << i)) == 0)
+			continue;
+
+		const PostEffect& effect = m_Effects[i];
+		switch (effect.Type)
+		{
+		case PostEffectType::Convolution:
+		{
+			uniforms.Convolve = 1;
+			std::copy(effect.Kernel, effect.Kernel + 9, uniforms.Kernel);
+			break;
+		}
+		case PostEffectType::Blur:
+		{
+			// Outer product of the 1D weights
+			float weights[2];
+			GaussianWeights(1, weights);
+			uniforms.Convolve = 1;
+			for (int y = 0; y < 3; y++)
+				for (int x = 0; x < 3; x++)
+					uniforms.Kernel[y * 3 + x] = weights[glm::abs(x - 1)] * weights[glm::abs(y - 1)];
+			break;
+		}
+		case PostEffectType::ColorGrade:
+		{
+			uniforms.ColorGrade = 1;
+			uniforms.Grade = effect.Grade;
+			break;
+		}
+		case PostEffectType::Vignette:
+		{
+			uniforms.Vignette = 1;
+			uniforms.VignetteShape = effect.VignetteShape;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	return uniforms;
+}
+
+void PostProcess::SetFusedUniforms(GLuint _program, const FusedLocations& _locations, const FusedUniforms& _uniforms)
+{
+	glProgramUniform1i(_program, _locations.Convolve, _uniforms.Convolve);
+	glProgramUniform1fv(_program, _locations.Kernel, 9, _uniforms.Kernel);
+	glProgramUniform1i(_program, _locations.ColorGrade, _uniforms.ColorGrade);
+	glProgramUniform3f(_program, _locations.Grade, _uniforms.Grade.x, _uniforms.Grade.y, _uniforms.Grade.z);
+	glProgramUniform1i(_program, _locations.Vignette, _uniforms.Vignette);
+	glProgramUniform2f(_program, _locations.VignetteShape, _uniforms.VignetteShape.x, _uniforms.VignetteShape.y);
+}
+
+PostProcess::FusedLocations PostProcess::GetFusedLocations(GLuint _program)
+{
+	FusedLocations locations{};
+	locations.Convolve = glGetUniformLocation(_program, "Convolve");
+	locations.Kernel = glGetUniformLocation(_program, "Kernel");
+	locations.ColorGrade = glGetUniformLocation(_program, "ColorGrade");
+	locations.Grade = glGetUniformLocation(_program, "Grade");
+	locations.Vignette = glGetUniformLocation(_program, "Vignette");
+	locations.VignetteShape = glGetUniformLocation(_program, "VignetteShape");
+	locations.RenderScale = glGetUniformLocation(_program, "RenderScale");
+	locations.UpscaleFactor = glGetUniformLocation(_program, "UpscaleFactor");
+	return locations;
+}
+
+unsigned PostProcess::AddGraphPass(RenderGraph& _graph, const PassPayload& _pass)
+{
+	// The graph holds on to it until Execute
+	PassPayload* pass = FrameAllocator::Allocate<PassPayload>(1);
+	assert(pass != nullptr);
+	if (pass == nullptr)
+		return ~0u;
+	*pass = _pass;
+
+	// Compute blurs store through an image, the graph adds the barrier before the next access
+	static const char* passNames[] = { "Post Fused", "Post Separable", "Post Compute" };
+	unsigned node = _graph.AddPass(passNames[(unsigned)pass->Pass.Kind], RecordPass, pass);
+	_graph.Read(node, pass->Source);
+	_graph.Write(node, pass->Target, pass->Pass.Kind == PostPassKind::Compute ? TargetAccess::Image : TargetAccess::RenderTarget);
+	return node;
+}
+
+void PostProcess::RecordPass(RenderGraph& _graph, CommandBuffer& _commands, unsigned _pass, const void* _data)
+{
+	const PassPayload& pass = *static_cast<const PassPayload*>(_data);
+	if (pass.Pass.Kind == PostPassKind::Compute)
+		_graph.BindImage(_commands, ImageUnit, pass.Target, GL_WRITE_ONLY);
+	else
+		_graph.BindRenderTargets(_commands, _pass, pass.RenderSize);
+	_graph.BindTexture(_commands, 0, pass.Source);
+	_commands.Callback(RunPass, _data, sizeof(PassPayload));
+}
+
+void PostProcess::RunPass(const void* _payload)
+{
+	const PassPayload& pass = *static_cast<const PassPayload*>(_payload);
+	switch (pass.Pass.Kind)
+	{
+	case PostPassKind::Fused:
+	{
+		glUseProgram(FusedShaderID);
+		SetFusedUniforms(FusedShaderID, m_FusedLocations, pass.Fused);
+		glProgramUniform2f(FusedShaderID, m_FusedLocations.RenderScale, pass.RenderScale.x, pass.RenderScale.y);
+		glProgramUniform1i(FusedShaderID, m_FusedLocations.UpscaleFactor, 0);
+		glBindVertexArray(VertexArrayID);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		break;
+	}
+	case PostPassKind::Separable:
+	{
+		glUseProgram(BlurShaderID);
+		glUniform2i(BlurDirectionLocation, pass.Direction.x, pass.Direction.y);
+		glUniform2i(BlurRenderSizeLocation, pass.RenderSize.x, pass.RenderSize.y);
+		glUniform1i(BlurRadiusLocation, pass.Pass.Radius);
+		glUniform1fv(BlurWeightsLocation, pass.Pass.Radius + 1, pass.Weights);
+		glBindVertexArray(VertexArrayID);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		break;
+	}
+	case PostPassKind::Compute:
+	{
+		// One group per tile of a row (or column)
+		glUseProgram(BlurComputeShaderID);
+		glUniform2i(ComputeDirectionLocation, pass.Direction.x, pass.Direction.y);
+		glUniform2i(ComputeRenderSizeLocation, pass.RenderSize.x, pass.RenderSize.y);
+		glUniform1i(ComputeRadiusLocation, pass.Pass.Radius);
+		glUniform1fv(ComputeWeightsLocation, pass.Pass.Radius + 1, pass.Weights);
+
+		int extent = pass.Direction.x != 0 ? pass.RenderSize.x : pass.RenderSize.y;
+		int across = pass.Direction.x != 0 ? pass.RenderSize.y : pass.RenderSize.x;
+		glDispatchCompute((extent + ComputeTileSize - 1) / ComputeTileSize, across, 1);
+		glBindImageTexture(ImageUnit, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+		break;
+	}
+	default:
+		break;
+	}
+
+	if (pass.IsLast)
+		EndTimedPass(&pass.Pass);
+}
+
+void PostProcess::EndTimedPass(const void* _payload)
+{
+	unsigned& count = m_SlotPassCounts[m_Slot];
+	assert(count < MaxPasses);
+	m_SlotPasses[m_Slot][count] = *static_cast<const PostPass*>(_payload);
+	WriteTimestamp(++count);
+}
+
+void PostProcess::BeginTimer(const void* _payload)
+{
+	const glm::ivec2& renderSize = *static_cast<const glm::ivec2*>(_payload);
+	CollectTimings();
+	// A slot still pending after QueryFrames frames is dropped and reused
+	m_Slot = (m_Slot + 1) % QueryFrames;
+	m_IsPending[m_Slot] = false;
+	m_SlotPassCounts[m_Slot] = 0;
+	WriteTimestamp(0);
+
+	// Passes cover the render size and write every texel they touch
+	glDisable(GL_BLEND);
+	glViewport(0, 0, renderSize.x, renderSize.y);
+}
+
+void PostProcess::WriteTimestamp(unsigned _index)
+{
+	glQueryCounter(QueryIDs[m_Slot][_index], GL_TIMESTAMP);
+}
+
+void PostProcess::CollectTimings()
+{
+	for (unsigned slot = 0; slot < QueryFrames; slot++)
+	{
+		if (!m_IsPending[slot])
+			continue;
+
+		unsigned count = m_SlotPassCounts[slot];
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(QueryIDs[slot][count], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE)
+			continue;
+
+		GLuint64 timestamps[MaxPasses + 1] = {};
+		for (unsigned i = 0; i <= count; i++)
+			glGetQueryObjectui64v(QueryIDs[slot][i], GL_QUERY_RESULT, &timestamps[i]);
+		m_IsPending[slot] = false;
+
+		std::lock_guard<std::mutex> lock(m_TimingMutex);
+		for (unsigned i = 0; i < count; i++)
+			m_Timings[i] = { m_SlotPasses[slot][i], (double)(timestamps[i + 1] - timestamps[i]) / 1000000.0 };
+		m_TimingCount = count;
+		m_HasTimings.store(true);
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include "FrameBuffer.h"
+#include "RenderGraph.h"
+#include "ShaderLoader.h"
+#include <atomic>
+#include <mutex>
+
+enum class PostEffectType : unsigned
+{
+	Convolution, // 3x3 kernel
+	Blur,        // Gaussian, Radius render pixels either side
+	ColorGrade,
+	Vignette
+};
+
+struct PostEffect
+{
+	PostEffectType Type = PostEffectType::Convolution;
+	const char* Name = "";
+	bool IsEnabled = true;
+
+	float Kernel[9] = { 0, 0, 0, 0, 1, 0, 0, 0, 0 }; // Convolution, rows from the top left
+	float Radius = 0.0f;                           // Blur
+	glm::vec3 Grade{ 1.0f };                       // ColorGrade : exposure, saturation, contrast
+	glm::vec2 VignetteShape{ 0.5f, 0.0f };         // Vignette : distance darkening starts (1 is a corner), strength
+};
+
+enum class PostPassKind : unsigned
+{
+	Fused,     // frameBuffer.frag with any of Convolution, ColorGrade, Vignette
+	Separable, // blur.frag twice
+	Compute    // blur.comp twice
+};
+
+struct PostPass
+{
+	PostPassKind Kind = PostPassKind::Fused;
+	unsigned Effects = 0; // bit per effect index
+	int Radius = 0;
+};
+
+// Effects applied between the scene and the window, in the order they were added. Disabled
+// effects and ones that would not change the image are skipped. Effects frameBuffer.frag has
+// a stage for run in one pass as long as they come in stage order (a 3x3 kernel first, then
+// grading, then vignette), and the last such run is fused into the composite itself, so a chain
+// without blurs costs no extra passes. Blurs of radius 1 fuse as a 3x3 kernel, up to
+// MaxSeparableRadius they run as two blur.frag passes and past that as two blur.comp dispatches
+// that share each tile and its aprons through shared memory. Each pass, and each direction of
+// a blur, is added to the frame's RenderGraph writing a transient target at the frame buffer's max
+// size and binding through it, so the graph culls passes nothing reads, aliases the intermediates
+// and places the barriers after compute blurs.
+//
+// Every pass is bracketed by timestamps in a ring of QueryFrames slots, read back once available
+// and printed by Report() every ReportFrames frames. Effects fused into one pass share its time.
+static class PostProcess
+{
+public:
+	// Call after the composite's frameBuffer.vert / frameBuffer.frag program is created
+	static void Init();
+	static void Shutdown();
+
+	// Returns the index for GetEffect, effects run in the order they are added
+	static unsigned AddEffect(const PostEffect& _effect);
+	inline static PostEffect& GetEffect(unsigned _index) { return m_Effects[_index]; }
+	inline static unsigned GetEffectCount() { return (unsigned)m_Effects.size(); }
+
+	// Adds the passes before the composite to _graph, reading _source. Returns the target the
+	// composite reads, _source itself when nothing runs before it. Call after FrameBuffer::UnBind
+	static unsigned AddPasses(RenderGraph& _graph, CommandBuffer& _commands, unsigned _source);
+	// From the composite's pass, binds _result to texture unit 0 and sets the fused effects
+	static void BeginComposite(RenderGraph& _graph, CommandBuffer& _commands, unsigned _result);
+	// Timestamp after the composite
+	static void EndFrame(CommandBuffer& _commands);
+
+	// Prints the latest pass times every ReportFrames frames
+	static void Report();
+
+	// Splits the enabled effects into passes, the last is the composite. Returns the pass count
+	static unsigned Plan(PostPass* _passes);
+	// Normalised weights for the centre and each of _radius taps either side
+	static void GaussianWeights(int _radius, float* _weights);
+
+	static const unsigned MaxEffects = 32;
+	static const unsigned MaxPasses = 8;
+	static const int MaxSeparableRadius = 8;
+	static const int MaxComputeRadius = 32;
+	static const unsigned ComputeTileSize = 128;
+	static const GLuint ImageUnit = 1;
+	static const unsigned QueryFrames = 4;
+	static const unsigned ReportFrames = 120;
+
+private:
+	struct FusedUniforms
+	{
+		GLint Convolve = 0;
+		float Kernel[9] = {};
+		GLint ColorGrade = 0;
+		glm::vec3 Grade{ 1.0f };
+		GLint Vignette = 0;
+		glm::vec2 VignetteShape{ 0.0f };
+	};
+
+	// Filled by GetFusedLocations
+	struct FusedLocations
+	{
+		GLint Convolve;
+		GLint Kernel;
+		GLint ColorGrade;
+		GLint Grade;
+		GLint Vignette;
+		GLint VignetteShape;
+		GLint RenderScale;
+		GLint UpscaleFactor;
+	};
+
+	// One graph pass, a fused pass or one direction of a blur
+	struct PassPayload
+	{
+		PostPass Pass;
+		unsigned Source; // graph targets
+		unsigned Target;
+		glm::ivec2 Direction; // blurs
+		bool IsLast;          // ends the post pass's timed span
+		glm::ivec2 RenderSize;
+		glm::vec2 RenderScale; // render size over the target size
+		FusedUniforms Fused;
+		float Weights[MaxComputeRadius + 1];
+	};
+
+	struct PassTiming
+	{
+		PostPass Pass;
+		double Milliseconds;
+	};
+
+	static bool IsNoOp(const PostEffect& _effect);
+	// Where the effect sits in frameBuffer.frag, -1 if it needs its own passes
+	static int GetStage(const PostEffect& _effect);
+	static FusedUniforms GetFusedUniforms(unsigned _effects);
+	static void SetFusedUniforms(GLuint _program, const FusedLocations& _locations, const FusedUniforms& _uniforms);
+	static FusedLocations GetFusedLocations(GLuint _program);
+
+	static unsigned AddGraphPass(RenderGraph& _graph, const PassPayload& _pass);
+	static void RecordPass(RenderGraph& _graph, CommandBuffer& _commands, unsigned _pass, const void* _data);
+	static void RunPass(const void* _payload);
+	static void EndTimedPass(const void* _payload);
+	static void BeginTimer(const void* _payload);
+	static void WriteTimestamp(unsigned _index);
+	static void CollectTimings();
+
+	inline static std::vector<PostEffect> m_Effects;
+
+	inline static GLuint CompositeShaderID = 0;
+	inline static GLuint FusedShaderID = 0;
+	inline static GLuint BlurShaderID = 0;
+	inline static GLuint BlurComputeShaderID = 0;
+	inline static GLuint VertexArrayID = 0;
+	inline static GLuint QueryIDs[QueryFrames][MaxPasses + 1] = {};
+	inline static FusedLocations m_CompositeLocations;
+	inline static FusedLocations m_FusedLocations;
+	inline static GLint BlurDirectionLocation = -1;
+	inline static GLint BlurRenderSizeLocation = -1;
+	inline static GLint BlurRadiusLocation = -1;
+	inline static GLint BlurWeightsLocation = -1;
+	inline static GLint ComputeDirectionLocation = -1;
+	inline static GLint ComputeRenderSizeLocation = -1;
+	inline static GLint ComputeRadiusLocation = -1;
+	inline static GLint ComputeWeightsLocation = -1;
+
+	// Simulation Thread
+	inline static unsigned m_Frame = 0;
+	inline static PostPass m_Passes[MaxPasses];
+	inline static unsigned m_PassCount = 0;
+
+	// Render Thread, passes count up as they run since the graph may cull some
+	inline static unsigned m_Slot = 0;
+	inline static bool m_IsPending[QueryFrames] = {};
+	inline static PostPass m_SlotPasses[QueryFrames][MaxPasses] = {};
+	inline static unsigned m_SlotPassCounts[QueryFrames] = {};
+
+	inline static std::mutex m_TimingMutex;
+	inline static PassTiming m_Timings[MaxPasses];
+	inline static unsigned m_TimingCount = 0;
+	inline static std::atomic<bool> m_HasTimings{ false };
+};
@@ -0,0 +1,487 @@
+#include "RenderGraph.h"
+#include <cassert>
+
+struct FormatInfo
+{
+	size_t Bytes;
+	bool IsFiltered;
+	bool IsDepth;
+};
+
+static FormatInfo GetFormatInfo(GLenum _format)
+{
+	switch (_format)
+	{
+	case GL_R8:					return { 1, true, false };
+	case GL_RGBA8:				return { 4, true, false };
+	case GL_R11F_G11F_B10F:		return { 4, true, false };
+	case GL_RGBA16F:			return { 8, true, false };
+	case GL_RGBA32F:			return { 16, true, false };
+	case GL_R32I:				return { 4, false, false };
+	case GL_R32UI:				return { 4, false, false };
+	case GL_DEPTH_COMPONENT32F:	return { 4, false, true };
+	case GL_DEPTH24_STENCIL8:	return { 4, false, true };
+	default:					return { 4, true, false };
+	}
+}
+
+// Every barrier an image store can owe
+static const GLbitfield ImageStoreBarriers = GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+
+size_t RenderTargetDesc::GetBytes() const
+{
+	return (size_t)Size.x * Size.y * GetFormatInfo(Format).Bytes;
+}
+
+void RenderGraph::Reset()
+{
+	m_Passes.clear();
+	m_Targets.clear();
+	m_Accesses.clear();
+}
+
+unsigned RenderGraph::Import(const char* _name, GLuint _texture, const RenderTargetDesc& _desc, bool _isKept)
+{
+	TargetNode target;
+	target.Name = _name;
+	target.Desc = _desc;
+	target.Texture = _texture;
+	target.IsKept = _isKept;
+	m_Targets.push_back(target);
+	return (unsigned)m_Targets.size() - 1;
+}
+
+unsigned RenderGraph::CreateTransient(const char* _name, const RenderTargetDesc& _desc)
+{
+	TargetNode target;
+	target.Name = _name;
+	target.Desc = _desc;
+	target.IsTransient = true;
+	m_Targets.push_back(target);
+	return (unsigned)m_Targets.size() - 1;
+}
+
+unsigned RenderGraph::AddPass(const char* _name, PassFunction _function, const void* _data)
+{
+	PassNode pass;
+	pass.Name = _name;
+	pass.Function = _function;
+	pass.Data = _data;
+	m_Passes.push_back(pass);
+	return (unsigned)m_Passes.size() - 1;
+}
+
+void RenderGraph::Read(unsigned _pass, unsigned _target, TargetAccess _access)
+{
+	m_Accesses.push_back({ _pass, _target, _access, false });
+}
+
+void RenderGraph::Write(unsigned _pass, unsigned _target, TargetAccess _access)
+{
+	m_Accesses.push_back({ _pass, _target, _access, true });
+}
+
+void RenderGraph::SetSideEffect(unsigned _pass)
+{
+	m_Passes[_pass].HasSideEffect = true;
+}
+
+void RenderGraph::Compile()
+{
+	m_Stats = RenderGraphStats();
+	Cull();
+	AssignSlots();
+}
+
+void RenderGraph::Execute(CommandBuffer& _commands)
+{
+	Compile();
+
+	for (unsigned pass = 0; pass < m_Passes.size(); pass++)
+	{
+		PassNode& node = m_Passes[pass];
+		if (node.IsCulled)
+			continue;
+
+		// Barriers Owed By Earlier Image Stores
+		GLbitfield barriers = 0;
+		for (auto& access : m_Accesses)
+		{
+			if (access.Pass != pass)
+				continue;
+
+			TargetNode& target = m_Targets[access.Target];
+			if (target.IsTransient && target.FirstPass == (int)pass)
+			{
+				// The slot's last occupant may still owe them
+				target.Unflushed |= m_SlotUnflushed[target.Slot];
+				m_SlotUnflushed[target.Slot] = 0;
+			}
+			GLbitfield needed = target.Unflushed & GetBarrierBit(access.Access);
+			barriers |= needed;
+			target.Unflushed &= ~needed;
+		}
+		if (barriers != 0)
+		{
+			_commands.Callback([](const void* _payload) { glMemoryBarrier(*static_cast<const GLbitfield*>(_payload)); }, &barriers, sizeof(barriers));
+			m_Stats.Barriers++;
+		}
+
+		node.Function(*this, _commands, pass, node.Data);
+
+		for (auto& access : m_Accesses)
+		{
+			if (access.Pass != pass)
+				continue;
+
+			TargetNode& target = m_Targets[access.Target];
+			if (access.IsWrite && access.Access == TargetAccess::Image)
+				target.Unflushed = ImageStoreBarriers;
+
+			// Contents Are Dead After The Last Pass, The Slot's Next Occupant Overwrites Them
+			if (target.IsTransient && target.LastPass == (int)pass && target.Slot >= 0)
+			{
+				m_SlotUnflushed[target.Slot] |= target.Unflushed;
+				target.Unflushed = 0;
+
+				struct InvalidatePayload
+				{
+					RenderGraph* Graph;
+					TargetRef Ref;
+				};
+				InvalidatePayload invalidate{ this, GetRef(access.Target) };
+				_commands.Callback([](const void* _payload)
+					{
+						const InvalidatePayload& invalidate = *static_cast<const InvalidatePayload*>(_payload);
+						glInvalidateTexImage(invalidate.Graph->Resolve(invalidate.Ref), 0);
+					}, &invalidate, sizeof(invalidate));
+				target.Slot = -1;
+			}
+		}
+	}
+}
+
+void RenderGraph::BindTexture(CommandBuffer& _commands, GLuint _unit, unsigned _target)
+{
+	const TargetNode& target = m_Targets[_target];
+	if (!target.IsTransient)
+	{
+		_commands.BindTextureUnit(_unit, target.Texture);
+		return;
+	}
+
+	struct BindPayload
+	{
+		RenderGraph* Graph;
+		GLuint Unit;
+		TargetRef Ref;
+	};
+	BindPayload bind{ this, _unit, GetRef(_target) };
+	_commands.Callback([](const void* _payload)
+		{
+			const BindPayload& bind = *static_cast<const BindPayload*>(_payload);
+			glBindTextureUnit(bind.Unit, bind.Graph->Resolve(bind.Ref));
+		}, &bind, sizeof(bind));
+}
+
+void RenderGraph::BindImage(CommandBuffer& _commands, GLuint _unit, unsigned _target, GLenum _access)
+{
+	struct BindPayload
+	{
+		RenderGraph* Graph;
+		GLuint Unit;
+		GLenum Access;
+		TargetRef Ref;
+	};
+	BindPayload bind{ this, _unit, _access, GetRef(_target) };
+	_commands.Callback([](const void* _payload)
+		{
+			const BindPayload& bind = *static_cast<const BindPayload*>(_payload);
+			glBindImageTexture(bind.Unit, bind.Graph->Resolve(bind.Ref), 0, GL_FALSE, 0, bind.Access, bind.Ref.Desc.Format);
+		}, &bind, sizeof(bind));
+}
+
+void RenderGraph::BindRenderTargets(CommandBuffer& _commands, unsigned _pass, const glm::ivec2& _viewport)
+{
+	struct TargetsPayload
+	{
+		RenderGraph* Graph;
+		unsigned Count;
+		TargetRef Refs[MaxPassTargets];
+		glm::ivec2 Viewport;
+	};
+	TargetsPayload targets{ this, 0, {}, glm::ivec2(0) };
+	for (auto& access : m_Accesses)
+	{
+		if (access.Pass == _pass && access.IsWrite && access.Access == TargetAccess::RenderTarget && targets.Count < MaxPassTargets)
+			targets.Refs[targets.Count++] = GetRef(access.Target);
+	}
+	targets.Viewport = _viewport != glm::ivec2(0) || targets.Count == 0 ? _viewport : targets.Refs[0].Desc.Size;
+
+	_commands.Callback([](const void* _payload)
+		{
+			const TargetsPayload& targets = *static_cast<const TargetsPayload*>(_payload);
+			RenderGraph& graph = *targets.Graph;
+
+			// The window is the default frame buffer
+			if (targets.Count == 1 && targets.Refs[0].Slot < 0 && targets.Refs[0].Texture == 0)
+			{
+				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				glViewport(0, 0, targets.Viewport.x, targets.Viewport.y);
+				return;
+			}
+
+			if (graph.m_FrameBufferID == 0)
+				glCreateFramebuffers(1, &graph.m_FrameBufferID);
+
+			GLenum buffers[MaxPassTargets] = {};
+			GLsizei colors = 0;
+			GLuint depth = 0;
+			for (unsigned i = 0; i < targets.Count; i++)
+			{
+				GLuint texture = graph.Resolve(targets.Refs[i]);
+				if (GetFormatInfo(targets.Refs[i].Desc.Format).IsDepth)
+					depth = texture;
+				else
+				{
+					glNamedFramebufferTexture(graph.m_FrameBufferID, GL_COLOR_ATTACHMENT0 + colors, texture, 0);
+					buffers[colors] = GL_COLOR_ATTACHMENT0 + colors;
+					colors++;
+				}
+			}
+
+			// Detach Whatever The Last Pass Left
+			for (GLsizei i = colors; i < (GLsizei)MaxPassTargets; i++)
+				glNamedFramebufferTexture(graph.m_FrameBufferID, GL_COLOR_ATTACHMENT0 + i, 0, 0);
+			glNamedFramebufferTexture(graph.m_FrameBufferID, GL_DEPTH_ATTACHMENT, depth, 0);
+
+			glNamedFramebufferDrawBuffers(graph.m_FrameBufferID, colors, buffers);
+			glBindFramebuffer(GL_FRAMEBUFFER, graph.m_FrameBufferID);
+			glViewport(0, 0, targets.Viewport.x, targets.Viewport.y);
+		}, &targets, sizeof(targets));
+}
+
+void RenderGraph::Report()
+{
+	if (++m_Frame % ReportFrames != 0)
+		return;
+
+	const double megabyte = 1024.0 * 1024.0;
+	Print(FrameAllocator::Format("RenderGraph : %u passes (%u culled) | %u transients in %u targets | %u barriers",
+		m_Stats.Passes, m_Stats.CulledPasses, m_Stats.Transients, m_Stats.Slots, m_Stats.Barriers));
+	Print(FrameAllocator::Format("  Peak %.2f MB live with imports, %.2f MB pooled (%.2f MB without aliasing) + %.2f MB imported",
+		m_Stats.PeakBytes / megabyte, m_Stats.AliasedBytes / megabyte, m_Stats.UnaliasedBytes / megabyte, m_Stats.ImportedBytes / megabyte));
+}
+
+void RenderGraph::PrintPasses() const
+{
+	for (unsigned pass = 0; pass < m_Passes.size(); pass++)
+	{
+		std::string_view reads = "", writes = "";
+		for (auto& access : m_Accesses)
+		{
+			if (access.Pass != pass)
+				continue;
+			std::string_view& list = access.IsWrite ? writes : reads;
+			list = FrameAllocator::Format(list.empty() ? "%.*s%s" : "%.*s, %s", (int)list.size(), list.data(), m_Targets[access.Target].Name);
+		}
+		Print(FrameAllocator::Format("  %-16s %s reads : %.*s | writes : %.*s", m_Passes[pass].Name, m_Passes[pass].IsCulled ? "culled" : "      ",
+			(int)reads.size(), reads.data(), (int)writes.size(), writes.data()));
+	}
+	for (auto& item : m_Targets)
+	{
+		if (item.IsTransient && item.FirstPass >= 0)
+			Print(FrameAllocator::Format("  %-16s %dx%d passes %d - %d", item.Name, item.Desc.Size.x, item.Desc.Size.y, item.FirstPass, item.LastPass));
+	}
+}
+
+void RenderGraph::Release()
+{
+	glDeleteTextures(MaxPoolTargets, m_SlotTextures);
+	for (auto& item : m_SlotTextures)
+		item = 0;
+	if (m_FrameBufferID != 0)
+		glDeleteFramebuffers(1, &m_FrameBufferID);
+	m_FrameBufferID = 0;
+	m_SlotCount = 0;
+	for (auto& item : m_SlotWasUsed)
+		item = false;
+}
+
+RenderGraph::TargetRef RenderGraph::GetRef(unsigned _target) const
+{
+	const TargetNode& target = m_Targets[_target];
+	return { target.Texture, target.Slot, target.Desc };
+}
+
+GLuint RenderGraph::Resolve(const TargetRef& _ref)
+{
+	if (_ref.Slot < 0)
+		return _ref.Texture;
+
+	// Slots get their texture the first time a pass uses them, and a new one once re-sized
+	GLuint& texture = m_SlotTextures[_ref.Slot];
+	if (texture != 0 && !(m_SlotTextureDescs[_ref.Slot] == _ref.Desc))
+	{
+		glDeleteTextures(1, &texture);
+		texture = 0;
+	}
+	if (texture == 0)
+	{
+		m_SlotTextureDescs[_ref.Slot] = _ref.Desc;
+		GLenum filter = GetFormatInfo(_ref.Desc.Format).IsFiltered ? GL_LINEAR : GL_NEAREST;
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, filter);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, filter);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureStorage2D(texture, 1, _ref.Desc.Format, _ref.Desc.Size.x, _ref.Desc.Size.y);
+	}
+	return texture;
+}
+
+void RenderGraph::Cull()
+{
+	for (auto& item : m_Targets)
+	{
+		item.Readers = item.IsTransient || !item.IsKept ? 0 : 1; // kept imports are read outside the graph
+		item.FirstPass = item.LastPass = -1;
+		item.Slot = -1;
+		item.Unflushed = 0;
+	}
+	for (auto& item : m_Passes)
+	{
+		item.References = item.HasSideEffect ? 1 : 0;
+		item.IsCulled = false;
+	}
+	for (auto& access : m_Accesses)
+	{
+		if (access.IsWrite)
+			m_Passes[access.Pass].References++;
+		else
+			m_Targets[access.Target].Readers++;
+	}
+
+	// Unread Targets Release Their Writers, Culled Writers Release What They Read
+	unsigned* unread = FrameAllocator::Allocate<unsigned>((unsigned)m_Targets.size());
+	unsigned count = 0;
+	for (unsigned i = 0; i < m_Targets.size(); i++)
+	{
+		if (m_Targets[i].Readers == 0)
+			unread[count++] = i;
+	}
+	while (count > 0)
+	{
+		unsigned target = unread[--count];
+		for (auto& access : m_Accesses)
+		{
+			PassNode& pass = m_Passes[access.Pass];
+			if (!access.IsWrite || access.Target != target || pass.IsCulled || --pass.References > 0)
+				continue;
+
+			pass.IsCulled = true;
+			for (auto& read : m_Accesses)
+			{
+				if (read.Pass == access.Pass && !read.IsWrite && --m_Targets[read.Target].Readers == 0)
+					unread[count++] = read.Target;
+			}
+		}
+	}
+}
+
+void RenderGraph::AssignSlots()
+{
+	// Lifetimes Over The Surviving Passes
+	for (unsigned pass = 0; pass < m_Passes.size(); pass++)
+	{
+		if (m_Passes[pass].IsCulled)
+		{
+			m_Stats.CulledPasses++;
+			continue;
+		}
+		m_Stats.Passes++;
+
+		for (auto& access : m_Accesses)
+		{
+			if (access.Pass != pass)
+				continue;
+			TargetNode& target = m_Targets[access.Target];
+			if (target.FirstPass < 0)
+				target.FirstPass = (int)pass;
+			target.LastPass = (int)pass;
+		}
+	}
+
+	// First Come First Served, A Slot Is Free Once Its Occupant's Last Pass Is Before This First One
+	for (unsigned slot = 0; slot < m_SlotCount; slot++)
+		m_SlotFreeAfter[slot] = -2;
+	for (auto& target : m_Targets)
+	{
+		if (!target.IsTransient && target.Texture != 0)
+			m_Stats.ImportedBytes += target.Desc.GetBytes();
+	}
+	m_Stats.PeakBytes = m_Stats.ImportedBytes;
+	bool isSlotUsed[MaxPoolTargets] = {};
+	for (unsigned pass = 0; pass < m_Passes.size(); pass++)
+	{
+		for (auto& target : m_Targets)
+		{
+			if (!target.IsTransient || target.FirstPass != (int)pass || target.Slot >= 0)
+				continue;
+
+			for (unsigned slot = 0; slot < m_SlotCount && target.Slot < 0; slot++)
+			{
+				if (m_SlotDescs[slot] == target.Desc && m_SlotFreeAfter[slot] < target.FirstPass)
+					target.Slot = (int)slot;
+			}
+			for (unsigned slot = 0; slot < m_SlotCount && target.Slot < 0; slot++)
+			{
+				if (!m_SlotWasUsed[slot] && !isSlotUsed[slot])
+					target.Slot = (int)slot;
+			}
+			if (target.Slot < 0)
+			{
+				assert(m_SlotCount < MaxPoolTargets);
+				target.Slot = (int)m_SlotCount++;
+			}
+			m_SlotDescs[target.Slot] = target.Desc;
+			m_SlotFreeAfter[target.Slot] = target.LastPass;
+
+			m_Stats.Transients++;
+			m_Stats.UnaliasedBytes += target.Desc.GetBytes();
+			if (!isSlotUsed[target.Slot])
+			{
+				isSlotUsed[target.Slot] = true;
+				m_Stats.Slots++;
+				m_Stats.AliasedBytes += target.Desc.GetBytes();
+			}
+		}
+
+		// Imports Stay Resident, Transients Only During Their Lifetime
+		size_t live = m_Stats.ImportedBytes;
+		for (auto& target : m_Targets)
+		{
+			if (target.IsTransient && target.FirstPass >= 0 && target.FirstPass <= (int)pass && target.LastPass >= (int)pass)
+				live += target.Desc.GetBytes();
+		}
+		m_Stats.PeakBytes = glm::max(m_Stats.PeakBytes, live);
+	}
+
+	for (unsigned slot = 0; slot < m_SlotCount; slot++)
+		m_SlotWasUsed[slot] = isSlotUsed[slot];
+}
+
+GLbitfield RenderGraph::GetBarrierBit(TargetAccess _access)
+{
+	switch (_access)
+	{
+	case TargetAccess::Sample:
+		return GL_TEXTURE_FETCH_BARRIER_BIT;
+	case TargetAccess::RenderTarget:
+		return GL_FRAMEBUFFER_BARRIER_BIT;
+	case TargetAccess::Image:
+		return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+	default:
+		return 0;
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include "CommandBuffer.h"
+#include "FrameAllocator.h"
+
+// How a pass touches a target, decides the barrier a later pass needs after image stores
+enum class TargetAccess : unsigned
+{
+	Sample,       // texture fetches
+	RenderTarget, // frame buffer attachment
+	Image         // image load / store
+};
+
+struct RenderTargetDesc
+{
+	glm::ivec2 Size{ 0 };
+	GLenum Format = GL_RGBA8;
+
+	inline bool operator==(const RenderTargetDesc& _other) const { return Size == _other.Size && Format == _other.Format; }
+	size_t GetBytes() const;
+};
+
+struct RenderGraphStats
+{
+	unsigned Passes = 0;
+	unsigned CulledPasses = 0;
+	unsigned Transients = 0;
+	unsigned Slots = 0;         // pool targets the transients were aliased into
+	unsigned Barriers = 0;
+	size_t PeakBytes = 0;       // most bytes alive at once, imports included
+	size_t AliasedBytes = 0;    // pool targets used this frame
+	size_t UnaliasedBytes = 0;  // every transient with its own target
+	size_t ImportedBytes = 0;
+};
+
+// Per frame graph of GPU passes over render targets. Passes and the targets they read and write
+// are declared on the simulation thread, Execute() then:
+//   culls passes whose writes never reach an imported target or a pass marked as a side effect,
+//   gives each transient target a pool slot, sharing slots of the same size and format between
+//   transients whose lifetimes do not overlap (GL has no placement, so aliasing is reuse of the
+//   same texture),
+//   records the surviving passes in the order they were added, with a glMemoryBarrier before any
+//   pass touching a target last written by image stores and a glInvalidateTexImage once a
+//   transient's last pass is done.
+// Pass functions record into the frame's CommandBuffer like any system. Transients only get a GL
+// texture on the render thread, so passes bind them through BindTexture / BindImage /
+// BindRenderTargets rather than by ID.
+class RenderGraph
+{
+public:
+	typedef void (*PassFunction)(RenderGraph& _graph, CommandBuffer& _commands, unsigned _pass, const void* _data);
+
+	// Frame Setup
+	void Reset();
+	// A texture owned elsewhere, 0 for the window. Writing one keeps the pass alive, unless _isKept
+	// is false for scratch the owner only reuses within the frame
+	unsigned Import(const char* _name, GLuint _texture, const RenderTargetDesc& _desc, bool _isKept = true);
+	// A target that only lives for this frame, allocated from the pool
+	unsigned CreateTransient(const char* _name, const RenderTargetDesc& _desc);
+	// _data has to stay valid until Execute
+	unsigned AddPass(const char* _name, PassFunction _function, const void* _data = nullptr);
+	void Read(unsigned _pass, unsigned _target, TargetAccess _access = TargetAccess::Sample);
+	void Write(unsigned _pass, unsigned _target, TargetAccess _access = TargetAccess::RenderTarget);
+	// Keeps a pass that only has effects outside the graph (timers, read backs)
+	void SetSideEffect(unsigned _pass);
+
+	void Compile();
+	// Compiles and records the frame's passes
+	void Execute(CommandBuffer& _commands);
+
+	// Recording helpers for pass functions
+	void BindTexture(CommandBuffer& _commands, GLuint _unit, unsigned _target);
+	void BindImage(CommandBuffer& _commands, GLuint _unit, unsigned _target, GLenum _access);
+	// Binds _pass's render target writes as its draw buffers, _viewport defaults to the first target's size
+	void BindRenderTargets(CommandBuffer& _commands, unsigned _pass, const glm::ivec2& _viewport = glm::ivec2(0));
+
+	inline const RenderGraphStats& GetStats() const { return m_Stats; }
+	inline bool IsCulled(unsigned _pass) const { return m_Passes[_pass].IsCulled; }
+	// Prints the stats every ReportFrames frames
+	void Report();
+	void PrintPasses() const;
+	// Deletes the pool, needs the GL context
+	void Release();
+
+	static const unsigned MaxPoolTargets = 16;
+	static const unsigned MaxPassTargets = 4;
+	static const unsigned ReportFrames = 120;
+
+private:
+	struct TargetNode
+	{
+		const char* Name = nullptr;
+		RenderTargetDesc Desc;
+		GLuint Texture = 0;
+		bool IsTransient = false;
+		bool IsKept = true;
+		int Slot = -1; // -1 once the last pass has released it
+
+		// Compile
+		unsigned Readers = 0;
+		int FirstPass = -1;
+		int LastPass = -1;
+		// Barrier bits still owed after image stores
+		GLbitfield Unflushed = 0;
+	};
+
+	struct PassNode
+	{
+		const char* Name = nullptr;
+		PassFunction Function = nullptr;
+		const void* Data = nullptr;
+		bool HasSideEffect = false;
+
+		// Compile
+		unsigned References = 0;
+		bool IsCulled = false;
+	};
+
+	struct TargetAccessNode
+	{
+		unsigned Pass;
+		unsigned Target;
+		TargetAccess Access;
+		bool IsWrite;
+	};
+
+	// What the render thread needs to find a target's texture
+	struct TargetRef
+	{
+		GLuint Texture;
+		int Slot;
+		RenderTargetDesc Desc;
+	};
+
+	TargetRef GetRef(unsigned _target) const;
+	GLuint Resolve(const TargetRef& _ref);
+	void Cull();
+	void AssignSlots();
+	static GLbitfield GetBarrierBit(TargetAccess _access);
+
+	std::vector<PassNode> m_Passes;
+	std::vector<TargetNode> m_Targets;
+	std::vector<TargetAccessNode> m_Accesses;
+	RenderGraphStats m_Stats;
+	unsigned m_Frame = 0;
+
+	// Pool, a slot no transient used last frame is re-sized before the pool grows (window resizes)
+	RenderTargetDesc m_SlotDescs[MaxPoolTargets];
+	bool m_SlotWasUsed[MaxPoolTargets] = {};
+	unsigned m_SlotCount = 0;
+	int m_SlotFreeAfter[MaxPoolTargets] = {};
+	GLbitfield m_SlotUnflushed[MaxPoolTargets] = {};
+
+	// Render Thread
+	GLuint m_SlotTextures[MaxPoolTargets] = {};
+	RenderTargetDesc m_SlotTextureDescs[MaxPoolTargets];
+	GLuint m_FrameBufferID = 0;
+};
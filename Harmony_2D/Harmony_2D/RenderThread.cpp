@@ -0,0 +1,135 @@
+#include "RenderThread.h"
+
+static double MillisecondsBetween(std::chrono::steady_clock::time_point _start, std::chrono::steady_clock::time_point _end)
+{
+	return std::chrono::duration<double, std::milli>(_end - _start).count();
+}
+
+void RenderThread::Start(GLFWwindow* _window)
+{
+	m_Window = _window;
+	m_LastSubmit = std::chrono::steady_clock::now();
+	if (!IsThreaded || m_Running)
+		return;
+
+	// Hand The Context Over
+	glfwMakeContextCurrent(nullptr);
+	m_Running = true;
+	m_Thread = std::thread(Loop);
+}
+
+void RenderThread::Stop()
+{
+	if (!m_Running)
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [] { return m_PendingIndex < 0; });
+		m_Running = false;
+	}
+	m_Condition.notify_all();
+	m_Thread.join();
+
+	// Take The Context Back For Cleanup
+	glfwMakeContextCurrent(m_Window);
+}
+
+CommandBuffer& RenderThread::BeginFrame()
+{
+	// Wait Until The Render Thread Is Done With This Packet
+	if (m_Running)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [] { return m_ReplayIndex != (int)m_WriteIndex && m_PendingIndex != (int)m_WriteIndex; });
+	}
+
+	m_FrameStart = std::chrono::steady_clock::now();
+	m_Packets[m_WriteIndex].Reset();
+	return m_Packets[m_WriteIndex];
+}
+
+void RenderThread::SubmitFrame()
+{
+	auto now = std::chrono::steady_clock::now();
+	double simulation = MillisecondsBetween(m_FrameStart, now);
+
+	if (!m_Running)
+	{
+		Present(m_Packets[m_WriteIndex]);
+		now = std::chrono::steady_clock::now();
+		m_Stats.Simulation = simulation;
+		m_Stats.Frame = MillisecondsBetween(m_LastSubmit, now);
+		m_LastSubmit = now;
+		return;
+	}
+
+	{
+		// One Packet In Flight At A Time
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [] { return m_PendingIndex < 0; });
+		m_PendingIndex = (int)m_WriteIndex;
+		now = std::chrono::steady_clock::now();
+		m_Stats.Simulation = simulation;
+		m_Stats.Frame = MillisecondsBetween(m_LastSubmit, now);
+		m_LastSubmit = now;
+	}
+	m_Condition.notify_all();
+	m_WriteIndex ^= 1;
+}
+
+RenderThreadStats RenderThread::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Stats;
+}
+
+void RenderThread::Loop()
+{
+	glfwMakeContextCurrent(m_Window);
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Condition.wait(lock, [] { return m_PendingIndex >= 0 || !m_Running; });
+			if (m_PendingIndex < 0)
+				break;
+
+			m_ReplayIndex = m_PendingIndex;
+			m_PendingIndex = -1;
+		}
+		m_Condition.notify_all();
+
+		Present(m_Packets[m_ReplayIndex]);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_ReplayIndex = -1;
+		}
+		m_Condition.notify_all();
+	}
+
+	glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::Present(const CommandBuffer& _packet)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	_packet.Execute();
+
+	// Swap Buffers
+	glfwSwapBuffers(m_Window);
+
+	double render = MillisecondsBetween(start, std::chrono::steady_clock::now());
+	if (m_Running)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stats.Render = render;
+	}
+	else
+	{
+		m_Stats.Render = render;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "CommandBuffer.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// Timings of the last frame, in milliseconds
+struct RenderThreadStats
+{
+	double Simulation = 0.0;
+	double Render = 0.0;
+	double Frame = 0.0;
+};
+
+// Owns the GL context and replays the recorded frame packets. Packets are double buffered,
+// so the simulation records frame N + 1 while frame N is replayed and swapped.
+// With IsThreaded false the packet is replayed inline on the calling thread instead.
+static class RenderThread
+{
+public:
+	static void Start(GLFWwindow* _window);
+	static void Stop();
+
+	// Returns the packet to record this frame into
+	static CommandBuffer& BeginFrame();
+	// Hands the packet to the render thread (or replays it inline) and presents it
+	static void SubmitFrame();
+
+	static RenderThreadStats GetStats();
+
+	inline static bool IsThreaded = true;
+
+private:
+	static void Loop();
+	static void Present(const CommandBuffer& _packet);
+
+	inline static GLFWwindow* m_Window = nullptr;
+	inline static CommandBuffer m_Packets[2];
+	inline static unsigned m_WriteIndex = 0;
+	inline static int m_PendingIndex = -1;
+	inline static int m_ReplayIndex = -1;
+	inline static std::atomic<bool> m_Running{ false };
+	inline static std::thread m_Thread;
+	inline static std::mutex m_Mutex;
+	inline static std::condition_variable m_Condition;
+
+	inline static std::chrono::steady_clock::time_point m_FrameStart;
+	inline static std::chrono::steady_clock::time_point m_LastSubmit;
+	inline static RenderThreadStats m_Stats;
+};
@@ -2,24 +2,22 @@
 
 layout (location = 0) out vec4 FragColor;
 layout (location = 1) out int ID;
-layout (location = 2) out vec4 HitPosition;
 
-in vec3 Position;
 in vec2 TexCoords;
-in mat4 Model_pass;
-in mat4 View_pass;
-in mat4 Proj_pass;
+flat in int ID_pass;
 
 uniform float Time;
-uniform int Id;
 uniform float Depth;
 uniform sampler2D Diffuse;
 
-vec3 GrabPositionFromDepth();
+// OverdrawAnalysis : one count per fragment
+layout (r32ui, binding = 0) uniform uimage2D OverdrawCounts;
+uniform bool Overdraw;
 
 void main()
 {
     FragColor = texture(Diffuse,TexCoords);
-    ID = Id;
-    HitPosition = Model_pass * vec4(Position,1.0f);
+    ID = ID_pass;
+    if (Overdraw)
+        imageAtomicAdd(OverdrawCounts, ivec2(gl_FragCoord.xy), 1u);
 } 
@@ -9,20 +9,79 @@ layout (std140, binding = 0) uniform Matrices
     mat4 view;
 };
 
-out vec3 Position;
+struct AnimationClip
+{
+    uint firstFrame;
+    uint frameCount;
+    float duration;
+    uint mode; // 0 loop, 1 once, 2 ping pong
+};
+
+struct AnimationFrame
+{
+    vec4 uvRect; // x, y, width, height
+    vec4 quad;   // trimmed rect inside the unit quad : center, size
+    float endTime;
+    uint hullCount; // 0 draws quad
+    vec2 hull[8];   // unit quad outline, fan triangulated
+};
+
+// AnimationLibrary tables
+layout (std430, binding = 7) readonly buffer Clips
+{
+    AnimationClip clips[];
+};
+
+layout (std430, binding = 8) readonly buffer Frames
+{
+    AnimationFrame frames[];
+};
+
 out vec2 TexCoords;
-out mat4 Model_pass;
-out mat4 View_pass;
-out mat4 Proj_pass;
+flat out int ID_pass;
 
 uniform mat4 Model;
+uniform int Id;
+uniform float Time; // seconds from the AnimationLibrary time origin
+uniform int Clip; // -1 for none
+uniform float ClipStart;
+uniform float ClipSpeed;
+
+// The clip's frame at _time seconds into it
+AnimationFrame SampleClip(uint _clip, float _time)
+{
+    AnimationClip clip = clips[_clip];
+    float time = max(_time, 0.0);
+    if (clip.mode == 1u)
+        time = min(time, clip.duration);
+    else if (clip.mode == 2u)
+    {
+        time = mod(time, 2.0 * clip.duration);
+        time = time < clip.duration ? time : 2.0 * clip.duration - time;
+    }
+    else
+        time = mod(time, clip.duration);
+
+    // Frames can have their own durations, clips are short enough to walk
+    uint frame = clip.firstFrame;
+    uint last = clip.firstFrame + clip.frameCount - 1u;
+    while (frame < last && time >= frames[frame].endTime)
+        frame++;
+    return frames[frame];
+}
 
 void main()
 {
-    Position = l_position;
+    vec3 position = l_position;
     TexCoords = l_texCoords;
-    Model_pass = Model;
-    View_pass = view;
-    Proj_pass = projection;
-	gl_Position = projection * view * Model * vec4(l_position,1.0f);
+    if (Clip >= 0)
+    {
+        // Trimmed frames shrink the unit quad to their rect
+        AnimationFrame frame = SampleClip(uint(Clip), (Time - ClipStart) * ClipSpeed);
+        TexCoords = frame.uvRect.xy + l_texCoords * frame.uvRect.zw;
+        position.xy = frame.quad.xy + l_position.xy * frame.quad.zw;
+    }
+    vec4 world = Model * vec4(position, 1.0f);
+    ID_pass = Id;
+	gl_Position = projection * view * world;
 }
\ No newline at end of file
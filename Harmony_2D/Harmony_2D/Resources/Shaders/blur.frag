@@ -0,0 +1,24 @@
+#version 460 core
+
+// One direction of a separable Gaussian blur over the render size (see PostProcess)
+out vec4 FragColor;
+
+uniform sampler2D Source;
+uniform ivec2 Direction;
+uniform ivec2 RenderSize;
+uniform int Radius;
+uniform float Weights[9]; // centre then each tap out, PostProcess::MaxSeparableRadius + 1
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    ivec2 last = RenderSize - 1;
+
+    vec4 color = texelFetch(Source, pixel, 0) * Weights[0];
+    for (int i = 1; i <= Radius; i++)
+    {
+        color += texelFetch(Source, clamp(pixel + Direction * i, ivec2(0), last), 0) * Weights[i];
+        color += texelFetch(Source, clamp(pixel - Direction * i, ivec2(0), last), 0) * Weights[i];
+    }
+    FragColor = color;
+}
@@ -1,33 +1,111 @@
 #version 460 core
 
-in vec3 Position;
 in vec2 TexCoords;
 
 out vec4 FragColor;
 
 uniform sampler2D screenTexture;
 
-const float offset_x = 1.0f/1080.0f;
-const float offset_y = 1.0f/1080.0f;
+// Part of the attachments the scene was rendered into, FrameBuffer::GetRenderScale
+uniform vec2 RenderScale = vec2(1.0f);
+// Pixel perfect upscale, window pixels per render pixel (0 stretches instead) and the window
+// pixels left of and below the upscaled image. Matches FrameBuffer::WindowToRenderPixel
+uniform int UpscaleFactor = 0;
+uniform vec2 UpscaleOffset;
 
+// Depth reconstruction, bind FrameBuffer::FrameBufferDepthTexture to sample positions
+uniform sampler2D DepthTexture;
+uniform mat4 InverseViewProjection;
+
+// PostProcess effects fused into this pass, run in this order (see PostProcess::GetStage)
+uniform bool Convolve;      // 3x3 Kernel, rows from the top left, otherwise one fetch
+uniform float Kernel[9];
+uniform bool ColorGrade;
+uniform vec3 Grade;         // exposure, saturation, contrast
+uniform bool Vignette;
+uniform vec2 VignetteShape; // distance darkening starts (1 is a corner), strength
+
+// OverdrawAnalysis heatmap
+uniform bool Overdraw;
+uniform usampler2D OverdrawCounts;
+uniform float HeatmapScale; // count at the top of the ramp
+
+// One texel of the render target, scaled per fragment in main
 vec2 offsets[9] = vec2[]
 (
-    vec2(-offset_x, offset_y), vec2(0.0f, offset_y),vec2(offset_x, offset_y),
-    vec2(-offset_x, 0.0f), vec2(0.0f, 0.0f),vec2(offset_x, 0.0f),
-    vec2(-offset_x, -offset_y), vec2(0.0f, -offset_y),vec2(offset_x, -offset_y)
+    vec2(-1.0f, 1.0f), vec2(0.0f, 1.0f),vec2(1.0f, 1.0f),
+    vec2(-1.0f, 0.0f), vec2(0.0f, 0.0f),vec2(1.0f, 0.0f),
+    vec2(-1.0f, -1.0f), vec2(0.0f, -1.0f),vec2(1.0f, -1.0f)
 );
 
-float kernel[9] = float[]
-(  
-    0,0,0,
-    0,1,0,
-    0,0,0
-);
+// World position of the pixel at _uv (0 - 1 over the rendered region) from the depth attachment,
+// matches FrameBuffer::ReconstructPosition
+vec3 GrabPositionFromDepth(vec2 _uv)
+{
+    float depth = texture(DepthTexture, _uv * RenderScale).r;
+    vec4 world = InverseViewProjection * vec4(vec3(_uv, depth) * 2.0f - 1.0f, 1.0f);
+    return world.xyz / world.w;
+}
+
+// Black for untouched, then blue, green, yellow, red as the count rises
+vec3 Heatmap(uint _count)
+{
+    if (_count == 0u)
+        return vec3(0.0f);
+    float heat = clamp(float(_count) / HeatmapScale, 0.0f, 1.0f) * 3.0f;
+    vec3 color = mix(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 0.0f), clamp(heat, 0.0f, 1.0f));
+    color = mix(color, vec3(1.0f, 1.0f, 0.0f), clamp(heat - 1.0f, 0.0f, 1.0f));
+    return mix(color, vec3(1.0f, 0.0f, 0.0f), clamp(heat - 2.0f, 0.0f, 1.0f));
+}
 
 void main()
 {
+    // Upscale, the window covers only the rendered part of the attachments
+    vec2 texel = 1.0f / vec2(textureSize(screenTexture, 0));
+    vec2 uv = TexCoords * RenderScale;
+    if (UpscaleFactor > 0)
+    {
+        // Whole render pixel under this window pixel, sampled at its centre so filtering acts as nearest
+        vec2 pixel = floor((gl_FragCoord.xy - UpscaleOffset) / float(UpscaleFactor));
+        if (any(lessThan(pixel, vec2(0.0f))) || any(greaterThanEqual(pixel, RenderScale / texel - 0.5f)))
+        {
+            FragColor = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            return;
+        }
+        uv = (pixel + 0.5f) * texel;
+    }
+
+    if (Overdraw)
+    {
+        ivec2 texel = ivec2(uv * vec2(textureSize(OverdrawCounts, 0)));
+        FragColor = vec4(Heatmap(texelFetch(OverdrawCounts, texel, 0).r), 1.0f);
+        return;
+    }
+
+    // Keep filtering off the stale texels past the rendered region
+    vec2 uvMin = 0.5f * texel;
+    vec2 uvMax = RenderScale - 0.5f * texel;
+
     vec3 color = vec3(0.0f);
-    for (int i = 0; i < 9; i++)
-        color += vec3(texture(screenTexture, TexCoords.st + offsets[i])) * kernel[i];
+    if (Convolve)
+    {
+        for (int i = 0; i < 9; i++)
+            color += vec3(texture(screenTexture, clamp(uv + offsets[i] * texel, uvMin, uvMax))) * Kernel[i];
+    }
+    else
+        color = vec3(texture(screenTexture, clamp(uv, uvMin, uvMax)));
+
+    if (ColorGrade)
+    {
+        color *= Grade.x;
+        color = mix(vec3(dot(color, vec3(0.2126f, 0.7152f, 0.0722f))), color, Grade.y);
+        color = (color - 0.5f) * Grade.z + 0.5f;
+    }
+
+    if (Vignette)
+    {
+        float fromCentre = length(uv / RenderScale - 0.5f) * 1.41421356f;
+        color *= 1.0f - VignetteShape.y * smoothstep(VignetteShape.x, 1.0f, fromCentre);
+    }
     FragColor = vec4(color,1.0f);
 } 
\ No newline at end of file
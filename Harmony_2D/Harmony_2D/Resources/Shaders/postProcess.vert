@@ -0,0 +1,11 @@
+#version 460 core
+
+// One triangle covering the viewport from gl_VertexID, no vertex buffers. Same outputs as
+// frameBuffer.vert so PostProcess can draw frameBuffer.frag into its targets
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	gl_Position = vec4(TexCoords * 2.0f - 1.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,23 @@
+#version 460 core
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out int ID;
+
+in vec2 TexCoords;
+flat in float TextureLayer;
+flat in vec4 Color;
+flat in int ID_pass;
+
+uniform sampler2DArray Diffuse;
+
+// OverdrawAnalysis : one count per fragment
+layout (r32ui, binding = 0) uniform uimage2D OverdrawCounts;
+uniform bool Overdraw;
+
+void main()
+{
+    FragColor = texture(Diffuse,vec3(TexCoords,TextureLayer)) * Color;
+    ID = ID_pass;
+    if (Overdraw)
+        imageAtomicAdd(OverdrawCounts, ivec2(gl_FragCoord.xy), 1u);
+}
@@ -0,0 +1,149 @@
+#version 460 core
+
+// No vertex attributes : one SpriteInstance per sprite, each run sets its vertices per sprite (see SpriteBatch)
+struct SpriteInstance
+{
+    vec2 translation; // relative to the floating origin
+    vec2 ab;          // first column of the 2x2
+    vec2 cd;          // second column
+    uint uvMin;       // unorm16x2, flipbook : clip low 16 bits, half speed high 16
+    uint uvMax;       // unorm16x2, flipbook : float start time
+    uint color;       // unorm8x4
+    uint id;          // pick ID bits 0 - 23, texture layer 24 - 30, flipbook flag 31
+    float layer;
+};
+
+struct AnimationClip
+{
+    uint firstFrame;
+    uint frameCount;
+    float duration;
+    uint mode; // 0 loop, 1 once, 2 ping pong
+};
+
+struct AnimationFrame
+{
+    vec4 uvRect; // x, y, width, height
+    vec4 quad;   // trimmed rect inside the unit quad : center, size
+    float endTime;
+    uint hullCount; // 0 draws quad
+    vec2 hull[8];   // unit quad outline, fan triangulated
+};
+
+layout (std430, binding = 1) readonly buffer Sprites
+{
+    SpriteInstance sprites[];
+};
+
+// GPU culling : compacted instance indices from spriteCull.comp, one draw per run
+layout (std430, binding = 2) readonly buffer Visible
+{
+    uint visible[];
+};
+
+struct DrawRun
+{
+    uint textureID;
+    uint first;
+    uint count;
+    uint vertices;
+};
+
+layout (std430, binding = 3) readonly buffer Runs
+{
+    DrawRun runs[];
+};
+
+// AnimationLibrary tables
+layout (std430, binding = 7) readonly buffer Clips
+{
+    AnimationClip clips[];
+};
+
+layout (std430, binding = 8) readonly buffer Frames
+{
+    AnimationFrame frames[];
+};
+
+layout (std140, binding = 0) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+uniform int SpriteBase;
+uniform bool Culled;
+uniform float Time; // seconds from the AnimationLibrary time origin
+uniform int SpriteVertices; // 6 for quads, 3 * (hull size - 2) for tight meshes
+uniform int RunBase;        // GPU culling : run of the multi draw's first draw, the run carries SpriteVertices
+
+out vec2 TexCoords;
+flat out float TextureLayer;
+flat out vec4 Color;
+flat out int ID_pass;
+
+// Unit quad corners, same winding as Mesh::Init. Drawn as a fan like the hulls, so a quad is
+// triangles 0 1 2, 0 2 3 and any further triangles collapse onto the last corner.
+const vec2 Corners[4] = vec2[](vec2(-0.5, 0.5), vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5));
+
+// The clip's frame at _time seconds into it
+AnimationFrame SampleClip(uint _clip, float _time)
+{
+    AnimationClip clip = clips[_clip];
+    float time = max(_time, 0.0);
+    if (clip.mode == 1u)
+        time = min(time, clip.duration);
+    else if (clip.mode == 2u)
+    {
+        time = mod(time, 2.0 * clip.duration);
+        time = time < clip.duration ? time : 2.0 * clip.duration - time;
+    }
+    else
+        time = mod(time, clip.duration);
+
+    // Frames can have their own durations, clips are short enough to walk
+    uint frame = clip.firstFrame;
+    uint last = clip.firstFrame + clip.frameCount - 1u;
+    while (frame < last && time >= frames[frame].endTime)
+        frame++;
+    return frames[frame];
+}
+
+void main()
+{
+    int spriteVertices = Culled ? int(runs[RunBase + gl_DrawID].vertices) : SpriteVertices;
+    int slot = gl_VertexID / spriteVertices;
+    SpriteInstance sprite = sprites[Culled ? int(visible[slot]) : SpriteBase + slot];
+
+    // Fan Vertex
+    int vertex = gl_VertexID % spriteVertices;
+    int fan = vertex % 3 == 0 ? 0 : vertex / 3 + vertex % 3;
+    vec2 corner = Corners[min(fan, 3)];
+
+    vec4 uvRect;
+    vec2 position = corner;
+    if ((sprite.id & 0x80000000u) != 0u)
+    {
+        // Flipbook frames shrink the quad to their trimmed rect, or to their hull with tight meshes
+        float speed = unpackHalf2x16(sprite.uvMin).y;
+        AnimationFrame frame = SampleClip(sprite.uvMin & 0xFFFFu, (Time - uintBitsToFloat(sprite.uvMax)) * speed);
+        uvRect = vec4(frame.uvRect.xy, frame.uvRect.xy + frame.uvRect.zw);
+        if (spriteVertices > 6 && frame.hullCount > 0u)
+        {
+            position = frame.hull[min(uint(fan), frame.hullCount - 1u)];
+            corner = (position - frame.quad.xy) / frame.quad.zw;
+        }
+        else
+            position = frame.quad.xy + corner * frame.quad.zw;
+    }
+    else
+        uvRect = vec4(unpackUnorm2x16(sprite.uvMin), unpackUnorm2x16(sprite.uvMax));
+    TexCoords = mix(uvRect.xy, uvRect.zw, corner + 0.5);
+
+    mat2 basis = mat2(sprite.ab, sprite.cd);
+    vec3 world = vec3(sprite.translation + basis * position, sprite.layer); // relative to the floating origin
+    Color = unpackUnorm4x8(sprite.color);
+    TextureLayer = float(bitfieldExtract(sprite.id, 24, 7));
+    ID_pass = bitfieldExtract(int(sprite.id), 0, 24);
+	gl_Position = projection * view * vec4(world,1.0f);
+}
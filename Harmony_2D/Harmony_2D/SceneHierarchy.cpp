@@ -0,0 +1,223 @@
+#include "SceneHierarchy.h"
+#include <algorithm>
+
+unsigned SceneHierarchy::AddNode(const Affine2D& _local, int _parentHandle)
+{
+	// Append, Parent Links Are Indices Until The Next Sort
+	int parent = _parentHandle < 0 ? -1 : (int)m_HandleToIndex[_parentHandle];
+	unsigned index = (unsigned)Size();
+
+	// Still depth first when the parent's subtree already ends at the back
+	if (m_IsSorted && parent >= 0 && parent + m_SubtreeSize[parent] != index)
+		m_IsSorted = false;
+	if (m_IsSorted)
+	{
+		for (int ancestor = parent; ancestor >= 0; ancestor = m_Parent[ancestor])
+		{
+			m_SubtreeSize[ancestor]++;
+		}
+	}
+
+	unsigned handle;
+	if (m_FreeHandles.empty())
+	{
+		handle = (unsigned)m_HandleToIndex.size();
+		m_HandleToIndex.push_back(0);
+	}
+	else
+	{
+		handle = m_FreeHandles.back();
+		m_FreeHandles.pop_back();
+	}
+
+	m_Parent.push_back(parent);
+	m_SubtreeSize.push_back(1);
+	m_Handle.push_back(handle);
+	m_Local.push_back(_local);
+	m_World.push_back(Affine2D{});
+	m_Dirty.push_back(false);
+	m_HandleToIndex[handle] = index;
+
+	MarkDirty(index);
+	return handle;
+}
+
+void SceneHierarchy::RemoveNode(unsigned _handle)
+{
+	if (!m_IsSorted)
+		Sort();
+
+	unsigned index = m_HandleToIndex[_handle];
+	unsigned count = m_SubtreeSize[index];
+
+	// Shrink Ancestors
+	for (int ancestor = m_Parent[index]; ancestor >= 0; ancestor = m_Parent[ancestor])
+	{
+		m_SubtreeSize[ancestor] -= count;
+	}
+
+	// Drop Pending Updates For The Removed Subtree
+	m_DirtyHandles.erase(std::remove_if(m_DirtyHandles.begin(), m_DirtyHandles.end(),
+		[&](unsigned _dirty) { unsigned dirtyIndex = m_HandleToIndex[_dirty]; return dirtyIndex >= index && dirtyIndex < index + count; }),
+		m_DirtyHandles.end());
+
+	for (unsigned i = index; i < index + count; i++)
+	{
+		m_FreeHandles.push_back(m_Handle[i]);
+	}
+
+	m_Parent.erase(m_Parent.begin() + index, m_Parent.begin() + index + count);
+	m_SubtreeSize.erase(m_SubtreeSize.begin() + index, m_SubtreeSize.begin() + index + count);
+	m_Handle.erase(m_Handle.begin() + index, m_Handle.begin() + index + count);
+	m_Local.erase(m_Local.begin() + index, m_Local.begin() + index + count);
+	m_World.erase(m_World.begin() + index, m_World.begin() + index + count);
+	m_Dirty.erase(m_Dirty.begin() + index, m_Dirty.begin() + index + count);
+
+	for (auto& item : m_Parent)
+	{
+		if (item >= (int)index)
+			item -= count;
+	}
+	for (unsigned i = index; i < Size(); i++)
+	{
+		m_HandleToIndex[m_Handle[i]] = i;
+	}
+}
+
+void SceneHierarchy::SetLocal(unsigned _handle, const Affine2D& _local)
+{
+	unsigned index = m_HandleToIndex[_handle];
+	m_Local[index] = _local;
+	MarkDirty(index);
+}
+
+void SceneHierarchy::UpdateWorld()
+{
+	m_Stats.Nodes = (unsigned)Size();
+	m_Stats.DirtyRoots = (unsigned)m_DirtyHandles.size();
+	m_Stats.Recomputed = 0;
+
+	if (m_DirtyHandles.empty())
+		return;
+
+	if (!m_IsSorted)
+		Sort();
+
+	// Dirty Handles -> Sorted Indices
+	for (auto& item : m_DirtyHandles)
+	{
+		item = m_HandleToIndex[item];
+	}
+	std::sort(m_DirtyHandles.begin(), m_DirtyHandles.end());
+
+	// One forward pass: a dirty node recomputes its whole subtree range, and any dirty
+	// node inside a range that was already recomputed is skipped.
+	unsigned recomputedEnd = 0;
+	for (auto& root : m_DirtyHandles)
+	{
+		if (root < recomputedEnd)
+			continue;
+
+		unsigned end = root + m_SubtreeSize[root];
+		for (unsigned i = root; i < end; i++)
+		{
+			int parent = m_Parent[i];
+			m_World[i] = parent < 0 ? m_Local[i] : MultiplyAffine(m_World[parent], m_Local[i]);
+			m_Dirty[i] = false;
+		}
+		m_Stats.Recomputed += end - root;
+		recomputedEnd = end;
+	}
+
+	m_DirtyHandles.clear();
+}
+
+bool SceneHierarchy::IsInSubtree(unsigned _handle, unsigned _rootHandle) const
+{
+	int root = (int)m_HandleToIndex[_rootHandle];
+	for (int index = (int)m_HandleToIndex[_handle]; index >= 0; index = m_Parent[index])
+	{
+		if (index == root)
+			return true;
+	}
+	return false;
+}
+
+void SceneHierarchy::MarkDirty(unsigned _index)
+{
+	if (m_Dirty[_index])
+		return;
+
+	m_Dirty[_index] = true;
+	m_DirtyHandles.push_back(m_Handle[_index]);
+}
+
+void SceneHierarchy::Sort()
+{
+	unsigned count = (unsigned)Size();
+
+	// Children Grouped By Parent, Roots In Bucket 0, Insertion Order Kept Within A Bucket
+	// Parent p's children end up in [m_ChildStart[p + 1], m_ChildStart[p + 2])
+	m_ChildStart.assign(count + 3, 0);
+	for (unsigned i = 0; i < count; i++)
+	{
+		m_ChildStart[m_Parent[i] + 3]++;
+	}
+	for (unsigned i = 1; i < count + 3; i++)
+	{
+		m_ChildStart[i] += m_ChildStart[i - 1];
+	}
+	m_Children.resize(count);
+	for (unsigned i = 0; i < count; i++)
+	{
+		m_Children[m_ChildStart[m_Parent[i] + 2]++] = i;
+	}
+
+	// Depth First Walk, m_Order[newIndex] = oldIndex. The walk stack lives in the back of
+	// m_Order, it never holds more than the nodes not yet emitted.
+	m_Order.resize(count);
+	unsigned emitted = 0;
+	unsigned stack = count;
+	for (unsigned i = m_ChildStart[1]; i-- > m_ChildStart[0];)
+	{
+		m_Order[--stack] = m_Children[i];
+	}
+	while (stack < count)
+	{
+		unsigned node = m_Order[stack++];
+		m_Order[emitted++] = node;
+		for (unsigned i = m_ChildStart[node + 2]; i-- > m_ChildStart[node + 1];)
+		{
+			m_Order[--stack] = m_Children[i];
+		}
+	}
+
+	// Old Index -> New Index
+	for (unsigned i = 0; i < count; i++)
+	{
+		m_Children[m_Order[i]] = i;
+	}
+
+	Permute(m_Parent);
+	Permute(m_Handle);
+	Permute(m_Local);
+	Permute(m_World);
+	Permute(m_Dirty);
+
+	for (unsigned i = 0; i < count; i++)
+	{
+		if (m_Parent[i] >= 0)
+			m_Parent[i] = (int)m_Children[m_Parent[i]];
+		m_HandleToIndex[m_Handle[i]] = i;
+	}
+
+	// Subtree Sizes, Children Always Follow Their Parent
+	m_SubtreeSize.assign(count, 1);
+	for (unsigned i = count; i-- > 0;)
+	{
+		if (m_Parent[i] >= 0)
+			m_SubtreeSize[m_Parent[i]] += m_SubtreeSize[i];
+	}
+
+	m_IsSorted = true;
+}
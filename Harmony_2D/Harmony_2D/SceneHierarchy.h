@@ -0,0 +1,70 @@
+#pragma once
+#include "Helper.h"
+
+struct HierarchyStats
+{
+	unsigned Nodes = 0;
+	unsigned DirtyRoots = 0;
+	unsigned Recomputed = 0;
+};
+
+// Parent / child transforms stored depth first in flat arrays, so every subtree is the
+// contiguous range [index, index + m_SubtreeSize[index]) and parents always precede children.
+// New nodes are appended and the arrays are re-sorted once before the next pass that needs the order.
+// Nodes are addressed through stable handles because sorting and removals shift indices.
+class SceneHierarchy
+{
+public:
+	unsigned AddNode(const Affine2D& _local, int _parentHandle = -1);
+	void RemoveNode(unsigned _handle);
+
+	void SetLocal(unsigned _handle, const Affine2D& _local);
+	inline const Affine2D& GetLocal(unsigned _handle) const { return m_Local[m_HandleToIndex[_handle]]; }
+	inline const Affine2D& GetWorld(unsigned _handle) const { return m_World[m_HandleToIndex[_handle]]; }
+
+	void UpdateWorld();
+
+	// True when _handle is _rootHandle or below it, parent links hold whether or not the arrays are sorted
+	bool IsInSubtree(unsigned _handle, unsigned _rootHandle) const;
+
+	inline const HierarchyStats& GetStats() const { return m_Stats; }
+	inline size_t Size() const { return m_Parent.size(); }
+
+private:
+	void MarkDirty(unsigned _index);
+	void Sort();
+
+	template <typename T>
+	void Permute(std::vector<T>& _items) const
+	{
+		std::vector<T> sorted(_items.size());
+		for (size_t i = 0; i < m_Order.size(); i++)
+		{
+			sorted[i] = _items[m_Order[i]];
+		}
+		_items.swap(sorted);
+	}
+
+	// Depth First Arrays
+	std::vector<int> m_Parent;
+	std::vector<unsigned> m_SubtreeSize;
+	std::vector<unsigned> m_Handle;
+	std::vector<Affine2D> m_Local;
+	std::vector<Affine2D> m_World;
+	std::vector<bool> m_Dirty;
+
+	// Handle -> Index
+	std::vector<unsigned> m_HandleToIndex;
+	std::vector<unsigned> m_FreeHandles;
+
+	// Handles whose local transform changed since the last UpdateWorld
+	std::vector<unsigned> m_DirtyHandles;
+
+	// Appends that broke the depth first order, subtree sizes are stale until Sort
+	bool m_IsSorted = true;
+	std::vector<unsigned> m_Order;
+	std::vector<unsigned> m_ChildStart;
+	std::vector<unsigned> m_Children;
+
+	HierarchyStats m_Stats;
+};
@@ -1,5 +1,5 @@
 #pragma once
-#include "Helper.h"
+#include "FrameAllocator.h"
 
 static class ShaderLoader
 {
@@ -30,7 +30,7 @@ public:
         {
             if (item.first.vertShader == _vertexShader.data() && item.first.geoShader == _geoShader.data() && item.first.fragShader == _fragmentShader.data())
             {
-                Print("Re-used Shader Program " + std::to_string(item.second) + "!");
+                Print(FrameAllocator::Format("Re-used Shader Program %u!", item.second));
                 return item.second;
             }
         }
@@ -71,7 +71,7 @@ public:
         {
             if (item.first.vertShader == _vertexShader && item.first.geoShader == "" && item.first.fragShader == _fragmentShader)
             {
-                Print("Re-used Shader Program " + std::to_string(item.second) + "!");
+                Print(FrameAllocator::Format("Re-used Shader Program %u!", item.second));
                 return item.second;
             }
         }
@@ -99,11 +99,51 @@ public:
         glLinkProgram(program);
         glValidateProgram(program);
 
+        LintVaryings(_vertexShader, vertShader, _fragmentShader, fragShader);
+
         ShaderPrograms.push_back(std::make_pair(ShaderProgramLocation{ _vertexShader.data(), "", _fragmentShader.data() }, program));
 
         // Return Program ID
         return program;
     }
+    inline static GLuint CreateComputeShader(std::string_view _computeShader)
+    {
+        for (auto& item : ShaderPrograms)
+        {
+            if (item.first.vertShader == _computeShader && item.first.geoShader == "" && item.first.fragShader == "")
+            {
+                Print(FrameAllocator::Format("Re-used Shader Program %u!", item.second));
+                return item.second;
+            }
+        }
+
+        // Create Program
+        GLuint program = glCreateProgram();
+
+        // Create Shader And Store Its ID
+        GLuint computeShader = CompileShader(GL_COMPUTE_SHADER, PassFileToString(_computeShader));
+
+        // Attach Shader To Program
+        if (IsDebug)
+        {
+            Print("Attaching Shaders");
+        }
+        glAttachShader(program, computeShader);
+
+        // Link And Validate
+        if (IsDebug)
+        {
+            Print("Linking program");
+        }
+        glLinkProgram(program);
+        glValidateProgram(program);
+
+        // Compute programs are keyed by their one stage
+        ShaderPrograms.push_back(std::make_pair(ShaderProgramLocation{ _computeShader.data(), "", "" }, program));
+
+        // Return Program ID
+        return program;
+    }
     inline static void SetUniform1i(const GLuint& _program, std::string_view _location, GLint _value)
     {
         GLint location; 
@@ -230,6 +270,101 @@ public:
         m_Uniforms.push_back(std::make_pair(UniformLocation{ _program, _location.data() }, glGetUniformLocation(_program, _location.data())));
         glUniformMatrix4fv(m_Uniforms.back().second, 1, GL_FALSE, glm::value_ptr(_value));
     }
+
+    // Shader convention : per instance values (IDs, layers, colors) go through flat varyings and a
+    // vec3 world position is the only spatial varying, matrices stay uniforms. Float components
+    // past this are reported at link time.
+    static const unsigned MaxInterpolatedComponents = 16;
+
+    struct ShaderVarying
+    {
+        std::string Name;
+        unsigned Components = 0;
+        bool IsInteger = false;
+    };
+
+    // Active _interface (GL_PROGRAM_INPUT or GL_PROGRAM_OUTPUT) variables of one compiled stage, built-ins skipped
+    inline static std::vector<ShaderVarying> QueryVaryings(GLuint _shader, GLenum _interface)
+    {
+        // Link The Stage On Its Own, So Its Interface Is The Program's
+        GLuint program = glCreateProgram();
+        glProgramParameteri(program, GL_PROGRAM_SEPARABLE, GL_TRUE);
+        glAttachShader(program, _shader);
+        glLinkProgram(program);
+
+        std::vector<ShaderVarying> varyings;
+        GLint count = 0;
+        glGetProgramInterfaceiv(program, _interface, GL_ACTIVE_RESOURCES, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const GLenum properties[] = { GL_TYPE, GL_ARRAY_SIZE, GL_NAME_LENGTH };
+            GLint values[3] = {};
+            glGetProgramResourceiv(program, _interface, i, 3, properties, 3, nullptr, values);
+
+            ShaderVarying varying;
+            varying.Name.resize(std::max(values[2], 1));
+            glGetProgramResourceName(program, _interface, i, values[2], nullptr, varying.Name.data());
+            varying.Name.resize(values[2] > 0 ? values[2] - 1 : 0);
+            if (varying.Name.compare(0, 3, "gl_") == 0)
+                continue;
+
+            switch (values[0])
+            {
+            case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: varying.IsInteger = values[0] != GL_BOOL; [[fallthrough]];
+            case GL_FLOAT: varying.Components = 1; break;
+            case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: varying.IsInteger = true; [[fallthrough]];
+            case GL_FLOAT_VEC2: varying.Components = 2; break;
+            case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: varying.IsInteger = true; [[fallthrough]];
+            case GL_FLOAT_VEC3: varying.Components = 3; break;
+            case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: varying.IsInteger = true; [[fallthrough]];
+            case GL_FLOAT_VEC4: case GL_FLOAT_MAT2: varying.Components = 4; break;
+            case GL_FLOAT_MAT3: varying.Components = 9; break;
+            case GL_FLOAT_MAT4: varying.Components = 16; break;
+            default: varying.Components = 4; break;
+            }
+            varying.Components *= (unsigned)std::max(values[1], 1);
+            varyings.push_back(varying);
+        }
+
+        glDetachShader(program, _shader);
+        glDeleteProgram(program);
+        return varyings;
+    }
+
+    // Reports the components the rasterizer carries from _vertShader to _fragShader, then anything over budget
+    // or written but never read. Flat floats can't be told apart by the query, so count as interpolated
+    inline static void LintVaryings(std::string_view _vertexShader, GLuint _vertShader, std::string_view _fragmentShader, GLuint _fragShader)
+    {
+        std::vector<ShaderVarying> outputs = QueryVaryings(_vertShader, GL_PROGRAM_OUTPUT);
+        std::vector<ShaderVarying> inputs = QueryVaryings(_fragShader, GL_PROGRAM_INPUT);
+        unsigned interpolated = 0, integer = 0;
+        for (auto& input : inputs)
+        {
+            if (input.IsInteger)
+                integer += input.Components;
+            else
+                interpolated += input.Components;
+        }
+
+        GLint maxComponents = 0;
+        glGetIntegerv(GL_MAX_VARYING_COMPONENTS, &maxComponents);
+        Print(FrameAllocator::Format("Varyings %s -> %s : %u/%u interpolated, %u integer components",
+            _vertexShader.data(), _fragmentShader.data(), interpolated, MaxInterpolatedComponents, integer));
+
+        // Findings
+        if (interpolated > MaxInterpolatedComponents)
+            Print(FrameAllocator::Format("    Over the %u interpolated component budget", MaxInterpolatedComponents));
+        if (maxComponents > 0 && interpolated + integer > (unsigned)maxComponents)
+            Print(FrameAllocator::Format("    Over the %i component device limit", maxComponents));
+        for (auto& output : outputs)
+        {
+            bool isRead = false;
+            for (auto& input : inputs)
+                isRead |= input.Name == output.Name;
+            if (!isRead)
+                Print(FrameAllocator::Format("    %s is written but never read (%u components)", output.Name.c_str(), output.Components));
+        }
+    }
 private:
     inline static GLuint CompileShader(GLenum _type, std::string _source)
     {
@@ -237,7 +372,7 @@ private:
         {
             if (item.first == _source)
             {
-                Print("Re-used Shader " + std::to_string(item.second) + "!");
+                Print(FrameAllocator::Format("Re-used Shader %u!", item.second));
                 return item.second;
             }
         }
@@ -266,6 +401,11 @@ private:
                 Print("Compiling geometry shader.");
                 break;
             }
+            case GL_COMPUTE_SHADER:
+            {
+                Print("Compiling compute shader.");
+                break;
+            }
             default:
                 break;
             }
@@ -0,0 +1,524 @@
+#include "SpriteBatch.h"
+#include <cstring>
+
+SpriteBatch::SpriteBatch(Camera& _camera, unsigned _maxSprites)
+{
+	m_Camera = &_camera;
+	m_Runs.reserve(64);
+
+	// Shader
+	ShaderID = ShaderLoader::CreateShader("Resources/Shaders/sprite.vert", "Resources/Shaders/sprite.frag");
+	glUseProgram(ShaderID);
+
+	// Empty Vertex Array, Core Profile Needs One Bound To Draw
+	glCreateVertexArrays(1, &VertexArrayID);
+
+	// Mapped Instance Ring
+	RegionPayload storage{ this, 0, _maxSprites };
+	CreateStorage(&storage);
+
+	// Uniform Buffer
+	glGenBuffers(1, &UniformBufferID);
+	unsigned matrixBlockIndex = glGetUniformBlockIndex(ShaderID, "Matrices");
+	glUniformBlockBinding(ShaderID, matrixBlockIndex, 0);
+	glBindBuffer(GL_UNIFORM_BUFFER, UniformBufferID);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(m_Matrices), NULL, GL_STATIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glUniform1i(glGetUniformLocation(ShaderID, "Diffuse"), 0);
+	SpriteBaseLocation = glGetUniformLocation(ShaderID, "SpriteBase");
+	TimeLocation = glGetUniformLocation(ShaderID, "Time");
+	CulledLocation = glGetUniformLocation(ShaderID, "Culled");
+	SpriteVerticesLocation = glGetUniformLocation(ShaderID, "SpriteVertices");
+	RunBaseLocation = glGetUniformLocation(ShaderID, "RunBase");
+	OverdrawLocation = glGetUniformLocation(ShaderID, "Overdraw");
+
+	// Culling Shader And Buffers, Sized On First Use
+	CullShaderID = ShaderLoader::CreateComputeShader("Resources/Shaders/spriteCull.comp");
+	StageLocation = glGetUniformLocation(CullShaderID, "Stage");
+	CullBaseLocation = glGetUniformLocation(CullShaderID, "SpriteBase");
+	SpriteCountLocation = glGetUniformLocation(CullShaderID, "SpriteCount");
+	RunCountLocation = glGetUniformLocation(CullShaderID, "RunCount");
+	GroupCountLocation = glGetUniformLocation(CullShaderID, "GroupCount");
+	ViewRectLocation = glGetUniformLocation(CullShaderID, "ViewRect");
+	glCreateBuffers(1, &ResidentBufferID);
+	glCreateBuffers(1, &VisibleBufferID);
+	glCreateBuffers(1, &RunBufferID);
+	glCreateBuffers(1, &ScanBufferID);
+	glCreateBuffers(1, &GroupSumBufferID);
+	glCreateBuffers(1, &IndirectBufferID);
+
+	// Unbind
+	glUseProgram(0);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+	// Delete
+	{
+		for (auto& item : m_Fences)
+		{
+			if (item)
+				glDeleteSync(item);
+			item = nullptr;
+		}
+		glUnmapNamedBuffer(InstanceBufferID);
+		glDeleteBuffers(1, &UniformBufferID);
+		glDeleteBuffers(1, &ResidentBufferID);
+		glDeleteBuffers(1, &VisibleBufferID);
+		glDeleteBuffers(1, &RunBufferID);
+		glDeleteBuffers(1, &ScanBufferID);
+		glDeleteBuffers(1, &GroupSumBufferID);
+		glDeleteBuffers(1, &IndirectBufferID);
+		glDeleteVertexArrays(1, &VertexArrayID);
+		glDeleteBuffers(1, &InstanceBufferID);
+	}
+	m_Camera = nullptr;
+}
+
+void SpriteBatch::BeginFrame()
+{
+	m_DrawCalls = 0;
+	m_TextureBinds = 0;
+	m_SpritesDrawn = 0;
+	m_UploadBytes = 0;
+
+	m_Matrices[0] = m_Camera->GetProjectionMatrix();
+	m_Matrices[1] = m_Camera->GetViewMatrix();
+	m_ViewRect = m_Camera->GetViewRect();
+	m_Time = glfwGetTime();
+	AnimationLibrary::UpdateTimeOrigin(m_Time);
+}
+
+void SpriteBatch::Begin()
+{
+	BeginFrame();
+	m_SpriteCount = 0;
+	m_Instances.clear();
+	m_Runs.clear();
+
+	// Stage Until A Requested Resize Has Landed, The Old Mapping May Be Going Away
+	m_Region = m_Frame++ % FramesInFlight;
+	unsigned mappedSprites = m_MappedSprites.load(std::memory_order_acquire);
+	if (m_RequestedSprites <= mappedSprites)
+		m_RequestedSprites = 0;
+	m_RegionSprites = m_RequestedSprites == 0 ? mappedSprites : 0;
+	m_Write = m_Mapped.load(std::memory_order_acquire);
+	m_Write = m_Write ? m_Write + (size_t)m_Region * m_RegionSprites : nullptr;
+	m_IsStaging = m_Write == nullptr || m_RegionSprites == 0;
+}
+
+void SpriteBatch::Submit(const Affine2D& _matrix, float _layer, const glm::vec4& _uvRect, GLuint _textureID, int _id, GLuint _color, GLuint _textureLayer)
+{
+	unsigned sprite = GetSpriteCount();
+	WriteInstance(Allocate(1), _matrix, _layer, _uvRect, _color, _id, _textureLayer);
+	AddRun(_textureID, sprite, 1);
+}
+
+SpriteInstance* SpriteBatch::Allocate(unsigned _sprites)
+{
+	unsigned first = m_SpriteCount;
+	m_SpriteCount += _sprites;
+
+	// Out Of Mapped Space : Move This Frame To The Staging Copy
+	if (!m_IsStaging && m_SpriteCount > m_RegionSprites)
+	{
+		m_Instances.assign(m_Write, m_Write + first);
+		m_IsStaging = true;
+	}
+
+	if (m_IsStaging)
+	{
+		m_Instances.resize(m_SpriteCount);
+		return m_Instances.data() + first;
+	}
+	return m_Write + first;
+}
+
+void SpriteBatch::AddRun(GLuint _textureID, unsigned _firstSprite, unsigned _spriteCount, bool _hasHull)
+{
+	MergeRun(m_Runs, { _textureID, _firstSprite, _spriteCount, GetSpriteVertices(_hasHull) });
+}
+
+void SpriteBatch::MergeRun(std::vector<DrawRun>& _runs, const DrawRun& _run)
+{
+	// Merge With The Previous Run When Contiguous, Same Texture And Same Vertices
+	if (!_runs.empty())
+	{
+		DrawRun& last = _runs.back();
+		if (last.TextureID == _run.TextureID && last.Vertices == _run.Vertices && last.FirstSprite + last.SpriteCount == _run.FirstSprite)
+		{
+			last.SpriteCount += _run.SpriteCount;
+			return;
+		}
+	}
+	_runs.push_back(_run);
+}
+
+bool SpriteBatch::BeginResident(CommandBuffer& _commands, unsigned _sprites, unsigned _version)
+{
+	BeginFrame();
+
+	// Flipbook start times are stored against the time origin
+	bool isValid = m_IsResidentValid && _version == m_ResidentVersion && _sprites <= m_ResidentCapacity && m_ResidentTimeOrigin == AnimationLibrary::GetTimeOrigin();
+	if (_sprites > m_ResidentCapacity)
+	{
+		// Growing drops the contents, the caller rewrites every slot after this
+		m_ResidentCapacity = _sprites + _sprites / 2;
+		ResidentPayload resize{ this, 0, m_ResidentCapacity };
+		_commands.Callback(ResizeResident, &resize, sizeof(resize));
+	}
+	m_ResidentSprites = _sprites;
+	m_ResidentVersion = _version;
+	m_ResidentTimeOrigin = AnimationLibrary::GetTimeOrigin();
+	m_IsResidentValid = true;
+
+	if (!isValid)
+	{
+		m_ResidentRuns.clear();
+		m_IsRunsDirty = true;
+	}
+	return isValid;
+}
+
+SpriteInstance* SpriteBatch::WriteResident(CommandBuffer& _commands, unsigned _first, unsigned _count)
+{
+	size_t bytes = (size_t)_count * sizeof(SpriteInstance);
+	unsigned char* payload = (unsigned char*)_commands.CallbackPayload(UploadResident, sizeof(ResidentPayload) + bytes);
+	ResidentPayload upload{ this, _first, _count };
+	std::memcpy(payload, &upload, sizeof(upload));
+	m_UploadBytes += bytes;
+	return reinterpret_cast<SpriteInstance*>(payload + sizeof(upload));
+}
+
+void SpriteBatch::AddResidentRun(GLuint _textureID, unsigned _firstSprite, unsigned _spriteCount, bool _hasHull)
+{
+	MergeRun(m_ResidentRuns, { _textureID, _firstSprite, _spriteCount, GetSpriteVertices(_hasHull) });
+	m_IsRunsDirty = true;
+}
+
+// Everything but the UV words, built on the stack so mapped (write combined) memory is stored once
+static SpriteInstance PackInstance(const Affine2D& _matrix, float _layer, GLuint _color, int _id, GLuint _textureLayer)
+{
+	SpriteInstance instance;
+	instance.x = _matrix.tx;
+	instance.y = _matrix.ty;
+	instance.layer = _layer;
+	instance.padding = 0;
+	instance.a = _matrix.a;
+	instance.b = _matrix.b;
+	instance.c = _matrix.c;
+	instance.d = _matrix.d;
+	instance.color = _color;
+	instance.id = ((GLuint)_id & 0x00FFFFFF) | ((_textureLayer & 0x7F) << 24);
+	return instance;
+}
+
+void SpriteBatch::WriteInstance(SpriteInstance* _instance, const Affine2D& _matrix, float _layer, const glm::vec4& _uvRect, GLuint _color, int _id, GLuint _textureLayer)
+{
+	SpriteInstance instance = PackInstance(_matrix, _layer, _color, _id, _textureLayer);
+	instance.uvMin = glm::packUnorm2x16({ _uvRect.x, _uvRect.y });
+	instance.uvMax = glm::packUnorm2x16({ _uvRect.x + _uvRect.z, _uvRect.y + _uvRect.w });
+	*_instance = instance;
+}
+
+void SpriteBatch::WriteFlipbook(SpriteInstance* _instance, const Affine2D& _matrix, float _layer, unsigned _clip, double _startTime, float _speed, GLuint _color, int _id, GLuint _textureLayer)
+{
+	SpriteInstance instance = PackInstance(_matrix, _layer, _color, _id, _textureLayer);
+	instance.uvMin = (_clip & 0xFFFF) | (glm::packHalf2x16({ 0.0f, _speed }) & 0xFFFF0000);
+	float startTime = AnimationLibrary::ToShaderTime(_startTime);
+	std::memcpy(&instance.uvMax, &startTime, sizeof(float));
+	instance.id |= FlipbookBit;
+	*_instance = instance;
+}
+
+void SpriteBatch::Flush(CommandBuffer& _commands)
+{
+	if (m_SpriteCount == 0)
+	{
+		// Nothing To Draw, Still Fence So The Next Frame Waits On The Right Region
+		FenceFrame(_commands);
+		return;
+	}
+
+	unsigned sprites = m_SpriteCount;
+	if (m_IsStaging)
+	{
+		// Grow The Ring (once per request), Then Copy This Frame In On The Render Thread
+		if (sprites > m_MappedSprites.load(std::memory_order_acquire) && sprites > m_RequestedSprites)
+		{
+			m_RequestedSprites = sprites + sprites / 2;
+			RegionPayload storage{ this, 0, m_RequestedSprites };
+			_commands.Callback(CreateStorage, &storage, sizeof(storage));
+		}
+
+		size_t bytes = (size_t)sprites * sizeof(SpriteInstance);
+		unsigned char* payload = (unsigned char*)_commands.CallbackPayload(UploadStaging, sizeof(RegionPayload) + bytes);
+		RegionPayload upload{ this, m_Region, sprites };
+		std::memcpy(payload, &upload, sizeof(upload));
+		std::memcpy(payload + sizeof(upload), m_Instances.data(), bytes);
+	}
+
+	// Stream In Proj And View Mats
+	_commands.BufferSubData(UniformBufferID, 0, sizeof(m_Matrices), m_Matrices);
+	m_UploadBytes += sizeof(m_Matrices) + (size_t)sprites * sizeof(SpriteInstance);
+
+	// Bind
+	RegionPayload region{ this, m_Region, sprites };
+	_commands.UseProgram(ShaderID);
+	_commands.Callback(BindRegion, &region, sizeof(region));
+	_commands.BindVertexArray(VertexArrayID);
+	_commands.BindBufferBase(GL_UNIFORM_BUFFER, 0, UniformBufferID);
+	_commands.Uniform1i(CulledLocation, 0);
+	_commands.Uniform1f(TimeLocation, AnimationLibrary::ToShaderTime(m_Time));
+	_commands.Uniform1i(OverdrawLocation, OverdrawAnalysis::IsEnabled());
+	AnimationLibrary::Flush(_commands);
+
+	// Draw, gl_VertexID / SpriteVertices lands on the run's sprites
+	GLuint texture = 0;
+	unsigned vertices = 0;
+	for (auto& item : m_Runs)
+	{
+		if (item.TextureID != texture)
+		{
+			texture = item.TextureID;
+			_commands.BindTextureUnit(0, texture);
+			m_TextureBinds++;
+		}
+		if (item.Vertices != vertices)
+		{
+			vertices = item.Vertices;
+			_commands.Uniform1i(SpriteVerticesLocation, (GLint)vertices);
+		}
+		_commands.DrawArrays(GL_TRIANGLES, item.FirstSprite * vertices, item.SpriteCount * vertices);
+		m_DrawCalls++;
+	}
+	m_SpritesDrawn += sprites;
+	m_SpriteCount = 0;
+	m_Instances.clear();
+	m_Runs.clear();
+
+	FenceFrame(_commands);
+
+	// Unbind
+	_commands.BindTextureUnit(0, 0);
+	_commands.BindVertexArray(0);
+	_commands.UseProgram(0);
+}
+
+void SpriteBatch::FenceFrame(CommandBuffer& _commands)
+{
+	// Fence This Region, Keep At Most One Frame Queued On The GPU
+	RegionPayload region{ this, m_Region, 0 };
+	_commands.Callback(FenceRegion, &region, sizeof(region));
+	RegionPayload previous{ this, (m_Region + FramesInFlight - 1) % FramesInFlight, 0 };
+	_commands.Callback(WaitRegion, &previous, sizeof(previous));
+}
+
+void SpriteBatch::FlushResident(CommandBuffer& _commands)
+{
+	if (m_ResidentSprites == 0)
+		return;
+
+	// Runs Table, Only When It Changed
+	if (m_IsRunsDirty)
+	{
+		size_t runBytes = m_ResidentRuns.size() * sizeof(DrawRun);
+		unsigned char* payload = (unsigned char*)_commands.CallbackPayload(UploadRuns, sizeof(ResidentPayload) + runBytes);
+		ResidentPayload upload{ this, 0, (unsigned)m_ResidentRuns.size() };
+		std::memcpy(payload, &upload, sizeof(upload));
+		std::memcpy(payload + sizeof(upload), m_ResidentRuns.data(), runBytes);
+		m_UploadBytes += runBytes;
+		m_IsRunsDirty = false;
+	}
+
+	// Cull And Build The Indirect Draws On The GPU
+	CullPayload cull{ this, m_ResidentSprites, (unsigned)m_ResidentRuns.size(), m_ViewRect };
+	_commands.Callback(CullResident, &cull, sizeof(cull));
+
+	// Stream In Proj And View Mats
+	_commands.BufferSubData(UniformBufferID, 0, sizeof(m_Matrices), m_Matrices);
+	m_UploadBytes += sizeof(m_Matrices);
+
+	// Bind
+	_commands.UseProgram(ShaderID);
+	_commands.BindVertexArray(VertexArrayID);
+	_commands.BindBufferBase(GL_UNIFORM_BUFFER, 0, UniformBufferID);
+	_commands.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ResidentBufferID);
+	_commands.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, VisibleBufferID);
+	_commands.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, RunBufferID);
+	_commands.BindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBufferID);
+	_commands.Uniform1i(SpriteBaseLocation, 0);
+	_commands.Uniform1i(CulledLocation, 1);
+	_commands.Uniform1f(TimeLocation, AnimationLibrary::ToShaderTime(m_Time));
+	_commands.Uniform1i(OverdrawLocation, OverdrawAnalysis::IsEnabled());
+	AnimationLibrary::Flush(_commands);
+
+	// One Multi Draw Per Texture Array
+	for (unsigned first = 0; first < m_ResidentRuns.size();)
+	{
+		unsigned last = first + 1;
+		while (last < m_ResidentRuns.size() && m_ResidentRuns[last].TextureID == m_ResidentRuns[first].TextureID)
+			last++;
+
+		// sprite.vert reads each draw's vertices per sprite from runs[RunBase + gl_DrawID]
+		_commands.BindTextureUnit(0, m_ResidentRuns[first].TextureID);
+		m_TextureBinds++;
+		_commands.Uniform1i(RunBaseLocation, (GLint)first);
+		_commands.MultiDrawArraysIndirect(GL_TRIANGLES, first * sizeof(DrawArraysIndirectCommand), last - first);
+		m_DrawCalls++;
+		first = last;
+	}
+	m_SpritesDrawn += m_ResidentSprites;
+
+	// Unbind
+	_commands.BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	_commands.BindTextureUnit(0, 0);
+	_commands.BindVertexArray(0);
+	_commands.UseProgram(0);
+}
+
+void SpriteBatch::CreateStorage(const void* _payload)
+{
+	const RegionPayload& storage = *static_cast<const RegionPayload*>(_payload);
+	SpriteBatch& batch = *storage.Batch;
+
+	// Old Ring Must Be Idle Before It Goes
+	if (batch.InstanceBufferID != 0)
+	{
+		glFinish();
+		glUnmapNamedBuffer(batch.InstanceBufferID);
+		glDeleteBuffers(1, &batch.InstanceBufferID);
+	}
+	for (auto& item : batch.m_Fences)
+	{
+		if (item)
+			glDeleteSync(item);
+		item = nullptr;
+	}
+
+	GLsizeiptr bytes = (GLsizeiptr)storage.Sprites * sizeof(SpriteInstance) * FramesInFlight;
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &batch.InstanceBufferID);
+	glNamedBufferStorage(batch.InstanceBufferID, bytes, nullptr, flags);
+
+	batch.m_Mapped.store((SpriteInstance*)glMapNamedBufferRange(batch.InstanceBufferID, 0, bytes, flags), std::memory_order_release);
+	batch.m_MappedSprites.store(storage.Sprites, std::memory_order_release);
+}
+
+void SpriteBatch::UploadStaging(const void* _payload)
+{
+	const RegionPayload& upload = *static_cast<const RegionPayload*>(_payload);
+	SpriteBatch& batch = *upload.Batch;
+
+	SpriteInstance* region = batch.m_Mapped.load(std::memory_order_relaxed) + (size_t)upload.Region * batch.m_MappedSprites.load(std::memory_order_relaxed);
+	std::memcpy(region, static_cast<const unsigned char*>(_payload) + sizeof(RegionPayload), (size_t)upload.Sprites * sizeof(SpriteInstance));
+}
+
+void SpriteBatch::BindRegion(const void* _payload)
+{
+	const RegionPayload& region = *static_cast<const RegionPayload*>(_payload);
+	SpriteBatch& batch = *region.Batch;
+
+	// Whole ring bound, sprite.vert offsets gl_VertexID / SpriteVertices by this region's first instance
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.InstanceBufferID);
+	glUniform1i(batch.SpriteBaseLocation, (GLint)(region.Region * batch.m_MappedSprites.load(std::memory_order_relaxed)));
+}
+
+void SpriteBatch::FenceRegion(const void* _payload)
+{
+	const RegionPayload& region = *static_cast<const RegionPayload*>(_payload);
+	GLsync& fence = region.Batch->m_Fences[region.Region];
+	if (fence)
+		glDeleteSync(fence);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void SpriteBatch::WaitRegion(const void* _payload)
+{
+	const RegionPayload& region = *static_cast<const RegionPayload*>(_payload);
+	GLsync fence = region.Batch->m_Fences[region.Region];
+	if (fence)
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+}
+
+void SpriteBatch::ResizeResident(const void* _payload)
+{
+	const ResidentPayload& resize = *static_cast<const ResidentPayload*>(_payload);
+	glNamedBufferData(resize.Batch->ResidentBufferID, (GLsizeiptr)resize.Count * sizeof(SpriteInstance), nullptr, GL_DYNAMIC_DRAW);
+}
+
+void SpriteBatch::UploadResident(const void* _payload)
+{
+	const ResidentPayload& upload = *static_cast<const ResidentPayload*>(_payload);
+	glNamedBufferSubData(upload.Batch->ResidentBufferID, (GLintptr)upload.First * sizeof(SpriteInstance), (GLsizeiptr)upload.Count * sizeof(SpriteInstance),
+		static_cast<const unsigned char*>(_payload) + sizeof(ResidentPayload));
+}
+
+void SpriteBatch::UploadRuns(const void* _payload)
+{
+	const ResidentPayload& upload = *static_cast<const ResidentPayload*>(_payload);
+	SpriteBatch& batch = *upload.Batch;
+
+	// Grow
+	if (upload.Count > batch.m_CullRuns)
+	{
+		batch.m_CullRuns = upload.Count + upload.Count / 2;
+		glNamedBufferData(batch.RunBufferID, (GLsizeiptr)batch.m_CullRuns * sizeof(DrawRun), nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(batch.IndirectBufferID, (GLsizeiptr)batch.m_CullRuns * sizeof(DrawArraysIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+	}
+	glNamedBufferSubData(batch.RunBufferID, 0, (GLsizeiptr)upload.Count * sizeof(DrawRun), static_cast<const unsigned char*>(_payload) + sizeof(ResidentPayload));
+}
+
+void SpriteBatch::CullResident(const void* _payload)
+{
+	const CullPayload& cull = *static_cast<const CullPayload*>(_payload);
+	SpriteBatch& batch = *cull.Batch;
+	unsigned groups = (cull.Sprites + CullGroupSize - 1) / CullGroupSize;
+
+	// Grow
+	if (cull.Sprites > batch.m_CullSprites)
+	{
+		batch.m_CullSprites = cull.Sprites + cull.Sprites / 2;
+		unsigned maxGroups = (batch.m_CullSprites + CullGroupSize - 1) / CullGroupSize;
+		glNamedBufferData(batch.VisibleBufferID, (GLsizeiptr)batch.m_CullSprites * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(batch.ScanBufferID, (GLsizeiptr)batch.m_CullSprites * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(batch.GroupSumBufferID, (GLsizeiptr)(maxGroups + 1) * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	// Bind
+	glUseProgram(batch.CullShaderID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.ResidentBufferID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, batch.VisibleBufferID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, batch.RunBufferID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, batch.ScanBufferID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, batch.GroupSumBufferID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, batch.IndirectBufferID);
+	glUniform1i(batch.CullBaseLocation, 0);
+	glUniform1ui(batch.SpriteCountLocation, cull.Sprites);
+	glUniform1ui(batch.RunCountLocation, cull.Runs);
+	glUniform1ui(batch.GroupCountLocation, groups);
+	glUniform4fv(batch.ViewRectLocation, 1, glm::value_ptr(cull.ViewRect));
+
+	// Visibility And Group Scans
+	glUniform1i(batch.StageLocation, 0);
+	glDispatchCompute(groups, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	// Scan Of Group Totals
+	glUniform1i(batch.StageLocation, 1);
+	glDispatchCompute(1, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	// Compact
+	glUniform1i(batch.StageLocation, 2);
+	glDispatchCompute(groups, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	// Indirect Commands
+	glUniform1i(batch.StageLocation, 3);
+	glDispatchCompute((cull.Runs + CullGroupSize - 1) / CullGroupSize, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+	glUseProgram(0);
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include "ShaderLoader.h"
+#include "Camera.h"
+#include "CommandBuffer.h"
+#include "AnimationLibrary.h"
+#include "OverdrawAnalysis.h"
+#include <atomic>
+
+// Collects one SpriteInstance per sprite and draws one call per texture run. There are no vertex or
+// index buffers: sprite.vert pulls the instance from a storage buffer and derives the quad corner
+// from gl_VertexID, six vertices per sprite. Translations are relative to the camera's floating
+// origin. Flush records GL work into a CommandBuffer so the batch can be built off the render thread.
+//
+// Instances are written straight into a persistently mapped ring of FramesInFlight regions, so
+// worker threads fill disjoint ranges of GPU visible memory and the render thread only issues
+// the draws. A frame that does not fit the ring falls back to a staging copy and grows it.
+//
+// With GPU culling on, every sprite keeps a resident slot in a GPU buffer between frames. The caller
+// rewrites only the slots that changed (BeginResident / WriteResident), and the runs table is uploaded
+// only when it changed. spriteCull.comp culls the slots against the camera rectangle, compacts the survivors
+// with a prefix sum and writes one indirect draw per run. The draws cost one glMultiDrawArraysIndirect
+// per texture, and an unchanged frame costs no CPU work per sprite.
+//
+// Every run carries its own vertices per sprite. With tight meshes on, runs of flipbooks whose clip
+// has hulls take 3 * (SpriteFrame::MaxHullVertices - 2) and draw hull frames as that fan instead of a
+// quad, covering fewer pixels. Every other run stays at six vertices per sprite.
+class SpriteBatch
+{
+public:
+	SpriteBatch(Camera& _camera, unsigned _maxSprites = 65536);
+	~SpriteBatch();
+
+	void Begin();
+	void Submit(const Affine2D& _matrix, float _layer, const glm::vec4& _uvRect, GLuint _textureID, int _id, GLuint _color = 0xFFFFFFFF, GLuint _textureLayer = 0);
+	void Flush(CommandBuffer& _commands);
+
+	// Reserves _sprites instances and returns them so callers (e.g. worker threads) can fill
+	// disjoint ranges directly, then AddRun describes which texture each range of sprites uses and
+	// whether they are flipbooks with hulls (see GetSpriteVertices). The pointer is only valid until the next Allocate
+	SpriteInstance* Allocate(unsigned _sprites);
+	void AddRun(GLuint _textureID, unsigned _firstSprite, unsigned _spriteCount, bool _hasHull = false);
+	inline unsigned GetSpriteCount() const { return m_SpriteCount; }
+
+	// GPU culling : _sprites resident slots for the sprite set identified by _version. Returns false when
+	// every slot and run has to be written again (first use, growth, a new _version or culling switched on).
+	bool BeginResident(CommandBuffer& _commands, unsigned _sprites, unsigned _version);
+	// Space in the command stream for slots [_first, _first + _count), valid until the next recorded command
+	SpriteInstance* WriteResident(CommandBuffer& _commands, unsigned _first, unsigned _count);
+	void AddResidentRun(GLuint _textureID, unsigned _firstSprite, unsigned _spriteCount, bool _hasHull = false);
+	void FlushResident(CommandBuffer& _commands);
+
+	// _textureID in Submit and AddRun is a GL_TEXTURE_2D_ARRAY, _textureLayer picks the layer (0 - 127)
+	static void WriteInstance(SpriteInstance* _instance, const Affine2D& _matrix, float _layer, const glm::vec4& _uvRect, GLuint _color, int _id, GLuint _textureLayer = 0);
+	// As WriteInstance, but sprite.vert takes the UVs from an AnimationLibrary clip at (Time - _startTime) * _speed.
+	// _startTime is in glfwGetTime seconds, stored relative to the AnimationLibrary time origin
+	static void WriteFlipbook(SpriteInstance* _instance, const Affine2D& _matrix, float _layer, unsigned _clip, double _startTime, float _speed, GLuint _color, int _id, GLuint _textureLayer = 0);
+
+	// Top bit of SpriteInstance::id
+	static const GLuint FlipbookBit = 0x80000000;
+
+	inline unsigned GetDrawCalls() const { return m_DrawCalls; }
+	inline unsigned GetTextureBinds() const { return m_TextureBinds; }
+	inline unsigned GetSpritesDrawn() const { return m_SpritesDrawn; }
+	inline bool IsStaging() const { return m_IsStaging; }
+	inline void SetGPUCulling(bool _enabled)
+	{
+		// Resident slots go stale while culling is off
+		if (_enabled && !m_IsGPUCulling)
+			m_IsResidentValid = false;
+		m_IsGPUCulling = _enabled;
+	}
+	inline bool IsGPUCulling() const { return m_IsGPUCulling; }
+	inline void SetTightMeshes(bool _enabled)
+	{
+		// Resident runs carry the vertex counts
+		if (_enabled != m_IsTightMeshes)
+			m_IsResidentValid = false;
+		m_IsTightMeshes = _enabled;
+	}
+	inline bool IsTightMeshes() const { return m_IsTightMeshes; }
+	inline unsigned GetSpriteVertices(bool _hasHull) const { return m_IsTightMeshes && _hasHull ? 3 * (SpriteFrame::MaxHullVertices - 2) : 6; }
+	// Bytes handed to the GPU by the last Flush or FlushResident (instances, runs and uniforms)
+	inline size_t GetUploadBytes() const { return m_UploadBytes; }
+
+	static const unsigned FramesInFlight = 3;
+	static const unsigned CullGroupSize = 256;
+private:
+	GLuint ShaderID;
+	GLuint InstanceBufferID = 0;
+	GLuint VertexArrayID;
+	GLuint UniformBufferID;
+	GLint SpriteBaseLocation = -1;
+	GLint TimeLocation = -1;
+	GLint CulledLocation = -1;
+	GLint SpriteVerticesLocation = -1;
+	GLint RunBaseLocation = -1;
+	GLint OverdrawLocation = -1;
+
+	// GPU Culling
+	GLuint CullShaderID;
+	GLuint ResidentBufferID;
+	GLuint VisibleBufferID;
+	GLuint RunBufferID;
+	GLuint ScanBufferID;
+	GLuint GroupSumBufferID;
+	GLuint IndirectBufferID;
+	GLint StageLocation = -1;
+	GLint CullBaseLocation = -1;
+	GLint SpriteCountLocation = -1;
+	GLint RunCountLocation = -1;
+	GLint GroupCountLocation = -1;
+	GLint ViewRectLocation = -1;
+
+	// Also read as std430 by sprite.vert and spriteCull.comp
+	struct DrawRun
+	{
+		GLuint TextureID;
+		unsigned FirstSprite;
+		unsigned SpriteCount;
+		unsigned Vertices; // per sprite
+	};
+
+	struct DrawArraysIndirectCommand
+	{
+		GLuint Count;
+		GLuint InstanceCount;
+		GLuint First;
+		GLuint BaseInstance;
+	};
+
+	// Render thread callbacks
+	struct RegionPayload
+	{
+		SpriteBatch* Batch;
+		unsigned Region;
+		unsigned Sprites;
+	};
+	// Followed by Count SpriteInstances for resident uploads, or Count DrawRuns for the runs table
+	struct ResidentPayload
+	{
+		SpriteBatch* Batch;
+		unsigned First;
+		unsigned Count;
+	};
+	struct CullPayload
+	{
+		SpriteBatch* Batch;
+		unsigned Sprites;
+		unsigned Runs;
+		glm::vec4 ViewRect;
+	};
+	static void CreateStorage(const void* _payload);
+	static void UploadStaging(const void* _payload);
+	static void BindRegion(const void* _payload);
+	static void FenceRegion(const void* _payload);
+	static void WaitRegion(const void* _payload);
+	static void ResizeResident(const void* _payload);
+	static void UploadResident(const void* _payload);
+	static void UploadRuns(const void* _payload);
+	static void CullResident(const void* _payload);
+
+	void BeginFrame();
+	void FenceFrame(CommandBuffer& _commands);
+	static void MergeRun(std::vector<DrawRun>& _runs, const DrawRun& _run);
+
+	unsigned m_DrawCalls = 0;
+	unsigned m_TextureBinds = 0;
+	unsigned m_SpritesDrawn = 0;
+	size_t m_UploadBytes = 0;
+
+	glm::mat4 m_Matrices[2];
+	glm::vec4 m_ViewRect{ 0.0f };
+	double m_Time = 0.0;
+	bool m_IsGPUCulling = false;
+	bool m_IsTightMeshes = true;
+
+	// Culling buffer sizes (owned by the render thread)
+	unsigned m_CullSprites = 0;
+	unsigned m_CullRuns = 0;
+
+	// Resident Slots, Capacity As Requested From The Render Thread
+	unsigned m_ResidentCapacity = 0;
+	unsigned m_ResidentSprites = 0;
+	unsigned m_ResidentVersion = 0;
+	double m_ResidentTimeOrigin = 0.0;
+	bool m_IsResidentValid = false;
+	bool m_IsRunsDirty = false;
+	std::vector<DrawRun> m_ResidentRuns;
+
+	// Mapped Ring (m_MappedSprites instances per region, owned by the render thread)
+	std::atomic<SpriteInstance*> m_Mapped{ nullptr };
+	std::atomic<unsigned> m_MappedSprites{ 0 };
+	GLsync m_Fences[FramesInFlight] = {};
+
+	// This Frame
+	unsigned m_Frame = 0;
+	unsigned m_Region = 0;
+	unsigned m_RegionSprites = 0;
+	unsigned m_RequestedSprites = 0;
+	unsigned m_SpriteCount = 0;
+	bool m_IsStaging = false;
+	SpriteInstance* m_Write = nullptr;
+
+	std::vector<SpriteInstance> m_Instances;
+	std::vector<DrawRun> m_Runs;
+
+	Camera* m_Camera = nullptr;
+};
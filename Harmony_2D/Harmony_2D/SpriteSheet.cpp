@@ -0,0 +1,260 @@
+#include "SpriteSheet.h"
+#include "FrameAllocator.h"
+#include <STBI/stb_image.h>
+#include <algorithm>
+#include <cfloat>
+
+SpriteSheet SpriteSheet::Load(const char* _imagePath, unsigned _columns, unsigned _rows, float _frameDuration)
+{
+	SpriteSheet sheet;
+	std::string sheetPath = GetSheetPath(_imagePath);
+	if (sheet.Read(sheetPath.c_str()))
+	{
+		// Rebuild if the image was resized or the grid changed since it was sliced
+		GLint width, height, components;
+		bool isSameGrid = sheet.m_Grid == glm::uvec2(_columns, _rows);
+		if (isSameGrid && (!stbi_info(_imagePath, &width, &height, &components) || glm::ivec2(width, height) == sheet.m_ImageSize))
+			return sheet;
+	}
+
+	Print(FrameAllocator::Format("Slicing %s into %s", _imagePath, sheetPath.c_str()));
+	if (!Slice(_imagePath, sheetPath.c_str(), _columns, _rows, _frameDuration) || !sheet.Read(sheetPath.c_str()))
+		Print(FrameAllocator::Format("Failed to build %s", sheetPath.c_str()));
+	return sheet;
+}
+
+bool SpriteSheet::Slice(const char* _imagePath, const char* _sheetPath, unsigned _columns, unsigned _rows, float _frameDuration, const glm::vec2& _pivot, GLubyte _alphaThreshold)
+{
+	// Bottom left origin, matching the textures
+	stbi_set_flip_vertically_on_load(true);
+	GLint width, height, components;
+	GLubyte* imageData = stbi_load(_imagePath, &width, &height, &components, 4);
+	if (!imageData || _columns == 0 || _rows == 0)
+	{
+		stbi_image_free(imageData);
+		return false;
+	}
+
+	GLint cellWidth = width / (GLint)_columns;
+	GLint cellHeight = height / (GLint)_rows;
+	std::vector<SpriteFrame> frames;
+	frames.reserve(_columns * _rows);
+	for (unsigned row = 0; row < _rows; row++)
+	{
+		for (unsigned column = 0; column < _columns; column++)
+		{
+			glm::ivec2 cellMin = { (GLint)column * cellWidth, height - ((GLint)row + 1) * cellHeight };
+
+			// Opaque Bounds
+			glm::ivec2 min = cellMin + glm::ivec2(cellWidth, cellHeight);
+			glm::ivec2 max = cellMin;
+			for (GLint y = cellMin.y; y < cellMin.y + cellHeight; y++)
+			{
+				const GLubyte* pixel = imageData + ((size_t)y * width + cellMin.x) * 4;
+				for (GLint x = cellMin.x; x < cellMin.x + cellWidth; x++, pixel += 4)
+				{
+					if (pixel[3] > _alphaThreshold)
+					{
+						min = glm::min(min, glm::ivec2(x, y));
+						max = glm::max(max, glm::ivec2(x + 1, y + 1));
+					}
+				}
+			}
+			// Fully transparent cells keep a zero sized rect and draw nothing
+			if (max.x <= min.x || max.y <= min.y)
+				min = max = cellMin;
+
+			SpriteFrame frame;
+			glm::vec2 size = max - min;
+			glm::vec2 cellSize = { (float)cellWidth, (float)cellHeight };
+			frame.SourceRect = { cellMin, cellWidth, cellHeight };
+			frame.TrimmedRect = { min, max - min };
+			frame.UVRect = { glm::vec2(min) / glm::vec2(width, height), size / glm::vec2(width, height) };
+			frame.Quad = { (glm::vec2(min - cellMin) + size * 0.5f) / cellSize - _pivot, size / cellSize };
+			frame.Pivot = _pivot;
+			frame.Duration = _frameDuration;
+
+			// Hull In Pixels To Unit Quad
+			frame.HullCount = FitHull(imageData, width, min, max, _alphaThreshold, frame.Hull);
+			for (unsigned i = 0; i < frame.HullCount; i++)
+				frame.Hull[i] = (frame.Hull[i] - glm::vec2(cellMin)) / cellSize - _pivot;
+			frames.push_back(frame);
+		}
+	}
+	stbi_image_free(imageData);
+	imageData = nullptr;
+
+	std::ofstream file(_sheetPath, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	SpriteSheetHeader header{ Magic, Version, (GLuint)frames.size(), { width, height }, { _columns, _rows } };
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)frames.data(), frames.size() * sizeof(SpriteFrame));
+	return (bool)file;
+}
+
+std::string SpriteSheet::GetSheetPath(const char* _imagePath)
+{
+	std::string path = _imagePath;
+	size_t extension = path.find_last_of('.');
+	size_t directory = path.find_last_of("/\\");
+	if (extension != std::string::npos && (directory == std::string::npos || extension > directory))
+		path.resize(extension);
+	return path + ".sheet";
+}
+
+float SpriteSheet::GetTrimmedFill() const
+{
+	double trimmed = 0.0, source = 0.0;
+	for (auto& frame : m_Frames)
+	{
+		trimmed += (double)frame.TrimmedRect.z * frame.TrimmedRect.w;
+		source += (double)frame.SourceRect.z * frame.SourceRect.w;
+	}
+	return source > 0.0 ? (float)(trimmed / source) : 1.0f;
+}
+
+float SpriteSheet::GetCoveredPixels(unsigned _index) const
+{
+	const SpriteFrame& frame = m_Frames[_index];
+	if (frame.HullCount < 3)
+		return (float)frame.TrimmedRect.z * frame.TrimmedRect.w;
+
+	// Shoelace
+	float area = 0.0f;
+	for (unsigned i = 0; i < frame.HullCount; i++)
+	{
+		const glm::vec2& a = frame.Hull[i];
+		const glm::vec2& b = frame.Hull[(i + 1) % frame.HullCount];
+		area += a.x * b.y - b.x * a.y;
+	}
+	return 0.5f * glm::abs(area) * frame.SourceRect.z * frame.SourceRect.w;
+}
+
+static float Cross(const glm::vec2& _origin, const glm::vec2& _a, const glm::vec2& _b)
+{
+	return (_a.x - _origin.x) * (_b.y - _origin.y) - (_a.y - _origin.y) * (_b.x - _origin.x);
+}
+
+unsigned SpriteSheet::FitHull(const GLubyte* _imageData, GLint _width, const glm::ivec2& _min, const glm::ivec2& _max, GLubyte _alphaThreshold, glm::vec2* _hull)
+{
+	if (_max.x <= _min.x || _max.y <= _min.y)
+		return 0;
+
+	// Outer pixel corners of each row's first and last opaque pixel, x sorted per row
+	std::vector<glm::vec2> points;
+	for (GLint y = _min.y; y < _max.y; y++)
+	{
+		const GLubyte* row = _imageData + (size_t)y * _width * 4;
+		GLint left = _min.x;
+		while (left < _max.x && row[left * 4 + 3] <= _alphaThreshold)
+			left++;
+		if (left == _max.x)
+			continue;
+		GLint right = _max.x - 1;
+		while (row[right * 4 + 3] <= _alphaThreshold)
+			right--;
+
+		points.push_back({ (float)left, (float)y });
+		points.push_back({ (float)left, (float)y + 1 });
+		points.push_back({ (float)right + 1, (float)y });
+		points.push_back({ (float)right + 1, (float)y + 1 });
+	}
+	std::sort(points.begin(), points.end(), [](const glm::vec2& _a, const glm::vec2& _b) { return _a.x < _b.x || (_a.x == _b.x && _a.y < _b.y); });
+
+	// Monotone Chain, Counter Clockwise
+	std::vector<glm::vec2> hull(points.size() * 2);
+	size_t count = 0;
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		while (count >= 2 && Cross(hull[count - 2], hull[count - 1], points[i]) <= 0.0f)
+			count--;
+		hull[count++] = points[i];
+	}
+	for (size_t i = points.size() - 1, lower = count + 1; i-- > 0;)
+	{
+		while (count >= lower && Cross(hull[count - 2], hull[count - 1], points[i]) <= 0.0f)
+			count--;
+		hull[count++] = points[i];
+	}
+	hull.resize(count - 1);
+
+	// Drop the edge whose neighbours meet at the smallest added area until the hull fits,
+	// keeping every vertex inside the trimmed rect so the UVs never reach the next frame
+	glm::vec2 rectMin = _min, rectMax = _max;
+	while (hull.size() > SpriteFrame::MaxHullVertices)
+	{
+		size_t best = hull.size();
+		float bestArea = FLT_MAX;
+		glm::vec2 bestPoint;
+		for (size_t i = 0; i < hull.size(); i++)
+		{
+			const glm::vec2& a = hull[(i + hull.size() - 1) % hull.size()];
+			const glm::vec2& b = hull[i];
+			const glm::vec2& c = hull[(i + 1) % hull.size()];
+			const glm::vec2& d = hull[(i + 2) % hull.size()];
+
+			// b + t (b - a) = c + u (c - d)
+			glm::vec2 ab = b - a, dc = c - d;
+			float denominator = ab.x * dc.y - ab.y * dc.x;
+			if (glm::abs(denominator) < 1e-6f)
+				continue;
+			glm::vec2 bc = c - b;
+			float t = (bc.x * dc.y - bc.y * dc.x) / denominator;
+			float u = (bc.x * ab.y - bc.y * ab.x) / denominator;
+			if (t < 0.0f || u < 0.0f)
+				continue;
+
+			glm::vec2 point = b + t * ab;
+			if (glm::any(glm::lessThan(point, rectMin - 0.01f)) || glm::any(glm::greaterThan(point, rectMax + 0.01f)))
+				continue;
+
+			float area = 0.5f * glm::abs(Cross(b, c, point));
+			if (area < bestArea)
+			{
+				best = i;
+				bestArea = area;
+				bestPoint = glm::clamp(point, rectMin, rectMax);
+			}
+		}
+		if (best == hull.size())
+			break;
+
+		hull[best] = bestPoint;
+		hull.erase(hull.begin() + (best + 1) % hull.size());
+	}
+
+	// Fall back to the trimmed quad when no small hull beats it
+	float hullArea = 0.0f;
+	for (size_t i = 0; i < hull.size(); i++)
+		hullArea += 0.5f * Cross(glm::vec2(0.0f), hull[i], hull[(i + 1) % hull.size()]);
+	glm::vec2 rectSize = rectMax - rectMin;
+	if (hull.size() > SpriteFrame::MaxHullVertices || hullArea >= rectSize.x * rectSize.y)
+		return 0;
+
+	std::copy(hull.begin(), hull.end(), _hull);
+	return (unsigned)hull.size();
+}
+
+bool SpriteSheet::Read(const char* _sheetPath)
+{
+	std::ifstream file(_sheetPath, std::ios::binary);
+	if (!file)
+		return false;
+
+	SpriteSheetHeader header;
+	file.read((char*)&header, sizeof(header));
+	if (!file || header.Magic != Magic || header.Version != Version)
+		return false;
+
+	std::vector<SpriteFrame> frames(header.FrameCount);
+	file.read((char*)frames.data(), frames.size() * sizeof(SpriteFrame));
+	if (!file)
+		return false;
+
+	m_ImageSize = header.ImageSize;
+	m_Grid = header.Grid;
+	m_Frames = std::move(frames);
+	return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Helper.h"
+
+// One frame of a sheet as stored in the descriptor. Rects are in image pixels with a bottom left
+// origin, as stb_image loads them flipped. Everything the renderer needs is precomputed by the
+// slicing tool, so a lookup is an index into the frame array. The hull is a tighter fit than the
+// trimmed rect for art that is mostly transparent, at the cost of more vertices.
+struct SpriteFrame
+{
+	// Fan triangulated by sprite.vert, 3 * (MaxHullVertices - 2) vertices per sprite
+	static const unsigned MaxHullVertices = 8;
+
+	glm::vec4 UVRect{ 0.0f, 0.0f, 1.0f, 1.0f }; // trimmed rect in image UVs (x, y, width, height), scale by TextureLayer::UVScale
+	glm::vec4 Quad{ 0.0f, 0.0f, 1.0f, 1.0f };   // trimmed rect inside the unit quad : center offset from the pivot, size
+	glm::ivec4 SourceRect{ 0 };                  // untrimmed cell
+	glm::ivec4 TrimmedRect{ 0 };                 // bounds of the cell's opaque pixels
+	glm::vec2 Pivot{ 0.5f };                     // 0 - 1 across the source rect
+	GLfloat Duration = 0.1f;                     // seconds
+	GLuint HullCount = 0;                        // 0 draws the trimmed quad
+	glm::vec2 Hull[MaxHullVertices]{};           // convex outline around the opaque pixels in the unit quad, counter clockwise
+};
+
+// Binary layout : SpriteSheetHeader then FrameCount SpriteFrame records
+struct SpriteSheetHeader
+{
+	GLuint Magic = 0;
+	GLuint Version = 0;
+	GLuint FrameCount = 0;
+	glm::ivec2 ImageSize{ 0 };
+	glm::uvec2 Grid{ 0 }; // columns, rows the frames were sliced from
+};
+
+// Frame metadata for a sprite sheet image, read from a .sheet descriptor next to the image.
+// Frames are trimmed to their opaque pixels so sprites drawn from them cover less screen.
+class SpriteSheet
+{
+public:
+	// Reads _imagePath's descriptor (extension swapped for .sheet). A missing or out of date
+	// descriptor, or one sliced from another grid, is rebuilt with Slice() over a _columns x _rows grid.
+	static SpriteSheet Load(const char* _imagePath, unsigned _columns, unsigned _rows, float _frameDuration);
+
+	// Slicing and trimming tool : cuts the image into a _columns x _rows grid (left to right, top
+	// to bottom), trims each cell's alpha <= _alphaThreshold border, fits a convex hull of at most
+	// MaxHullVertices around what is left and writes the descriptor
+	static bool Slice(const char* _imagePath, const char* _sheetPath, unsigned _columns, unsigned _rows, float _frameDuration,
+		const glm::vec2& _pivot = { 0.5f, 0.5f }, GLubyte _alphaThreshold = 0);
+
+	static std::string GetSheetPath(const char* _imagePath);
+
+	inline const SpriteFrame& GetFrame(unsigned _index) const { return m_Frames[_index]; }
+	inline unsigned GetFrameCount() const { return (unsigned)m_Frames.size(); }
+	inline const std::vector<SpriteFrame>& GetFrames() const { return m_Frames; }
+	inline glm::ivec2 GetImageSize() const { return m_ImageSize; }
+	// Untrimmed size, what a sprite showing the frame is scaled to
+	inline glm::vec2 GetFrameSize(unsigned _index = 0) const { return m_Frames.empty() ? glm::vec2(m_ImageSize) : glm::vec2(m_Frames[_index].SourceRect.z, m_Frames[_index].SourceRect.w); }
+
+	// Trimmed area over untrimmed area across every frame
+	float GetTrimmedFill() const;
+	// Pixels the frame's hull (or trimmed quad without one) covers
+	float GetCoveredPixels(unsigned _index) const;
+
+	static const GLuint Magic = 0x54485348; // "HSHT"
+	static const GLuint Version = 3;
+
+private:
+	static unsigned FitHull(const GLubyte* _imageData, GLint _width, const glm::ivec2& _min, const glm::ivec2& _max, GLubyte _alphaThreshold, glm::vec2* _hull);
+	bool Read(const char* _sheetPath);
+
+	glm::ivec2 m_ImageSize{ 0 };
+	glm::uvec2 m_Grid{ 0 };
+	std::vector<SpriteFrame> m_Frames;
+};
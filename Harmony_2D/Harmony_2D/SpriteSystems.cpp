@@ -0,0 +1,217 @@
+#include "SpriteSystems.h"
+#include <cassert>
+#include <cstring>
+
+void SpriteSystems::UpdateTransforms(EntityRegistry& _registry)
+{
+	// Only Transforms Changed Since The Last Render
+	TransformStore& store = _registry.m_Transforms.m_Store;
+	store.ForEachDirtyRange([&](size_t _begin, size_t _end)
+	{
+		JobSystem::ParallelFor((unsigned)(_end - _begin), TransformGrainSize, [&](unsigned _first, unsigned _last)
+		{
+			store.Update(_begin + _first, _begin + _last);
+		});
+	});
+}
+
+void SpriteSystems::UpdateHierarchy(EntityRegistry& _registry)
+{
+	_registry.m_Hierarchy.UpdateWorld();
+
+	TransformPool& transforms = _registry.m_Transforms;
+	TransformStore& store = transforms.m_Store;
+	const glm::dvec2& origin = store.GetOrigin();
+	for (unsigned i = 0; i < _registry.m_HierarchyNodes.Size(); i++)
+	{
+		unsigned entityIndex = _registry.m_HierarchyNodes.m_Dense[i];
+		const HierarchyComponent& node = _registry.m_HierarchyNodes.m_Data[i];
+		if (!_registry.IsAlive(node.Anchor) || !transforms.Contains(entityIndex) || !transforms.Contains(node.Anchor.Index))
+			continue;
+
+		// Anchor Space -> Origin Relative World
+		unsigned transform = transforms.DenseIndex(entityIndex);
+		Affine2D world = MultiplyAffine(store.GetMatrix(transforms.DenseIndex(node.Anchor.Index)), _registry.m_Hierarchy.GetWorld(node.Node));
+
+		// Unchanged Since Last Frame, Leave The Page Clean. UpdateTransforms rewrites the linear part of
+		// dirty pages from the inputs, so compare against the store rather than the last result
+		glm::dvec2 position = { origin.x + world.tx, origin.y + world.ty };
+		if (store.m_A[transform] == world.a && store.m_B[transform] == world.b && store.m_C[transform] == world.c && store.m_D[transform] == world.d &&
+			store.m_WorldX[transform] == position.x && store.m_WorldY[transform] == position.y)
+			continue;
+
+		store.m_A[transform] = world.a;
+		store.m_B[transform] = world.b;
+		store.m_C[transform] = world.c;
+		store.m_D[transform] = world.d;
+		store.SetPosition(transform, position.x, position.y);
+	}
+}
+
+void SpriteSystems::Cull(EntityRegistry& _registry, const glm::vec4& _viewRect, FrameList<unsigned>& _visible)
+{
+	const TransformStore& store = _registry.m_Transforms.m_Store;
+	assert(_visible.Capacity >= store.Size());
+	unsigned count = glm::min((unsigned)store.Size(), _visible.Capacity);
+	unsigned chunks = (count + CullGrainSize - 1) / CullGrainSize;
+	unsigned* chunkCounts = FrameAllocator::Allocate<unsigned>(chunks);
+
+	// Each chunk writes its visible indices into its own slice of _visible
+	JobSystem::ParallelFor(count, CullGrainSize, [&](unsigned _begin, unsigned _end)
+	{
+		unsigned* output = _visible.Data + _begin;
+		unsigned written = 0;
+		for (unsigned i = _begin; i < _end; i++)
+		{
+			// Half extents of the transformed unit quad
+			float halfX = 0.5f * (glm::abs(store.m_A[i]) + glm::abs(store.m_C[i]));
+			float halfY = 0.5f * (glm::abs(store.m_B[i]) + glm::abs(store.m_D[i]));
+
+			bool visible = (store.m_X[i] + halfX >= _viewRect.x) & (store.m_X[i] - halfX <= _viewRect.z) &
+				(store.m_Y[i] + halfY >= _viewRect.y) & (store.m_Y[i] - halfY <= _viewRect.w);
+			if (visible)
+				output[written++] = i;
+		}
+		chunkCounts[_begin / CullGrainSize] = written;
+	});
+
+	// Compact Chunks
+	_visible.Size = 0;
+	for (unsigned i = 0; i < chunks; i++)
+	{
+		std::memmove(_visible.Data + _visible.Size, _visible.Data + i * CullGrainSize, chunkCounts[i] * sizeof(unsigned));
+		_visible.Size += chunkCounts[i];
+	}
+}
+
+void SpriteSystems::CollectAll(EntityRegistry& _registry, FrameList<unsigned>& _visible)
+{
+	assert(_visible.Capacity >= _registry.m_Transforms.Size());
+	unsigned count = glm::min((unsigned)_registry.m_Transforms.Size(), _visible.Capacity);
+	for (unsigned i = 0; i < count; i++)
+		_visible.Data[i] = i;
+	_visible.Size = count;
+}
+
+// One transform's instance, shared by the per frame and the resident paths
+static void WriteSprite(EntityRegistry& _registry, unsigned _transform, SpriteInstance* _instance)
+{
+	const TransformStore& store = _registry.m_Transforms.m_Store;
+	unsigned entityIndex = _registry.m_Transforms.m_Dense[_transform];
+	if (!_registry.m_Sprites.Contains(entityIndex))
+	{
+		// Degenerate Quad
+		SpriteBatch::WriteInstance(_instance, { 0, 0, 0, 0, 0, 0 }, 0.0f, {}, 0, -1);
+		return;
+	}
+
+	const SpriteComponent& sprite = _registry.m_Sprites.Get(entityIndex);
+	int id = _registry.m_PickIDs.Contains(entityIndex) ? _registry.m_PickIDs.Get(entityIndex).ID : -1;
+	if (_registry.m_Animations.Contains(entityIndex))
+	{
+		// Clip frames are already in layer UVs
+		const AnimationComponent& animation = _registry.m_Animations.Get(entityIndex);
+		SpriteBatch::WriteFlipbook(_instance, store.GetMatrix(_transform), store.m_Layer[_transform], animation.Clip, animation.StartTime, animation.Speed, sprite.Color, id, sprite.TextureLayer);
+		return;
+	}
+
+	glm::vec4 uvRect = sprite.UVRect * glm::vec4(sprite.UVScale, sprite.UVScale);
+	SpriteBatch::WriteInstance(_instance, store.GetMatrix(_transform), store.m_Layer[_transform], uvRect, sprite.Color, id, sprite.TextureLayer);
+}
+
+static GLuint GetTexture(EntityRegistry& _registry, unsigned _transform)
+{
+	unsigned entityIndex = _registry.m_Transforms.m_Dense[_transform];
+	return _registry.m_Sprites.Contains(entityIndex) ? _registry.m_Sprites.Get(entityIndex).TextureID : 0;
+}
+
+// Only flipbooks whose clip has hulls are worth tight mesh vertices
+static bool HasHull(EntityRegistry& _registry, unsigned _transform)
+{
+	unsigned entityIndex = _registry.m_Transforms.m_Dense[_transform];
+	return _registry.m_Animations.Contains(entityIndex) && AnimationLibrary::HasHull(_registry.m_Animations.Get(entityIndex).Clip);
+}
+
+void SpriteSystems::GenerateInstances(EntityRegistry& _registry, const FrameList<unsigned>& _visible, SpriteInstance* _instances)
+{
+	JobSystem::ParallelFor(_visible.size(), InstanceGrainSize, [&](unsigned _begin, unsigned _end)
+	{
+		for (unsigned i = _begin; i < _end; i++)
+		{
+			WriteSprite(_registry, _visible[i], _instances + i);
+		}
+	});
+}
+
+void SpriteSystems::GenerateResident(EntityRegistry& _registry, unsigned _begin, unsigned _end, SpriteInstance* _instances)
+{
+	JobSystem::ParallelFor(_end - _begin, InstanceGrainSize, [&](unsigned _first, unsigned _last)
+	{
+		for (unsigned i = _first; i < _last; i++)
+		{
+			WriteSprite(_registry, _begin + i, _instances + i);
+		}
+	});
+}
+
+void SpriteSystems::Render(EntityRegistry& _registry, const FrameList<unsigned>& _visible, SpriteBatch& _batch, CommandBuffer& _commands)
+{
+	TransformStore& store = _registry.m_Transforms.m_Store;
+	if (_batch.IsGPUCulling())
+	{
+		RenderResident(_registry, _batch, _commands);
+		store.ClearDirty();
+		return;
+	}
+
+	_batch.Begin();
+
+	unsigned first = _batch.GetSpriteCount();
+	SpriteInstance* instances = _batch.Allocate(_visible.size());
+	auto generate = [&](unsigned _begin, unsigned _end)
+	{
+		for (unsigned i = _begin; i < _end; i++)
+		{
+			WriteSprite(_registry, _visible[i], instances + i);
+		}
+	};
+	JobCounter generated;
+	JobSystem::ParallelForAsync(_visible.size(), InstanceGrainSize, generate, generated);
+
+	// Texture Runs While The Workers Write Instances
+	for (unsigned i = 0; i < _visible.size(); i++)
+	{
+		_batch.AddRun(GetTexture(_registry, _visible[i]), first + i, 1, HasHull(_registry, _visible[i]));
+	}
+	JobSystem::Wait(generated);
+
+	_batch.Flush(_commands);
+	store.ClearDirty();
+}
+
+void SpriteSystems::RenderResident(EntityRegistry& _registry, SpriteBatch& _batch, CommandBuffer& _commands)
+{
+	TransformStore& store = _registry.m_Transforms.m_Store;
+	unsigned count = (unsigned)store.Size();
+
+	if (!_batch.BeginResident(_commands, count, _registry.GetSpriteLayoutVersion()))
+	{
+		// New Sprite Set : Every Slot And Run
+		if (count > 0)
+			GenerateResident(_registry, 0, count, _batch.WriteResident(_commands, 0, count));
+		for (unsigned i = 0; i < count; i++)
+		{
+			_batch.AddResidentRun(GetTexture(_registry, i), i, 1, HasHull(_registry, i));
+		}
+	}
+	else if (store.IsDirty())
+	{
+		// Changed Ranges Only
+		store.ForEachDirtyRange([&](size_t _begin, size_t _end)
+		{
+			GenerateResident(_registry, (unsigned)_begin, (unsigned)_end, _batch.WriteResident(_commands, (unsigned)_begin, (unsigned)(_end - _begin)));
+		});
+	}
+
+	_batch.FlushResident(_commands);
+}
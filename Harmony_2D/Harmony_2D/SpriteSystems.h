@@ -0,0 +1,31 @@
+#pragma once
+#include "EntityRegistry.h"
+#include "SpriteBatch.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+
+// Systems over the packed EntityRegistry pools. Each walks its pool's dense arrays front to back;
+// transform update, culling and instance generation are split across the JobSystem workers.
+// Transform update and GPU culled rendering only touch the transforms marked dirty since the last Render.
+static class SpriteSystems
+{
+public:
+	static void UpdateTransforms(EntityRegistry& _registry);
+	// Propagates the hierarchy and overwrites the transforms of attached entities, runs after UpdateTransforms
+	static void UpdateHierarchy(EntityRegistry& _registry);
+	static void Cull(EntityRegistry& _registry, const glm::vec4& _viewRect, FrameList<unsigned>& _visible);
+	// Every transform, in order
+	static void CollectAll(EntityRegistry& _registry, FrameList<unsigned>& _visible);
+	static void GenerateInstances(EntityRegistry& _registry, const FrameList<unsigned>& _visible, SpriteInstance* _instances);
+	// Instances for transforms [_begin, _end), the resident slots of a GPU culled batch
+	static void GenerateResident(EntityRegistry& _registry, unsigned _begin, unsigned _end, SpriteInstance* _instances);
+	// _visible is ignored when the batch culls on the GPU, it keeps every sprite resident instead
+	static void Render(EntityRegistry& _registry, const FrameList<unsigned>& _visible, SpriteBatch& _batch, CommandBuffer& _commands);
+
+	inline static const unsigned TransformGrainSize = 16384;
+	inline static const unsigned CullGrainSize = 16384;
+	inline static const unsigned InstanceGrainSize = 2048;
+
+private:
+	static void RenderResident(EntityRegistry& _registry, SpriteBatch& _batch, CommandBuffer& _commands);
+};
@@ -0,0 +1,118 @@
+#include "TaskGraph.h"
+#include <fstream>
+
+unsigned TaskGraph::AddSystem(const char* _name, Resource _reads, Resource _writes, void (*_function)())
+{
+	SystemNode node;
+	node.Name = _name;
+	node.Function = _function;
+	node.Reads = _reads;
+	node.Writes = _writes;
+	m_Nodes.push_back(node);
+	m_Ready = std::vector<JobCounter>(m_Nodes.size());
+	return (unsigned)m_Nodes.size() - 1;
+}
+
+void TaskGraph::Build()
+{
+	for (auto& item : m_Nodes)
+	{
+		item.Successors.clear();
+		item.Predecessors.clear();
+		item.Level = 0;
+	}
+
+	// Edge From Every Earlier System That Conflicts
+	for (unsigned later = 0; later < m_Nodes.size(); later++)
+	{
+		SystemNode& node = m_Nodes[later];
+		for (unsigned earlier = 0; earlier < later; earlier++)
+		{
+			SystemNode& other = m_Nodes[earlier];
+			bool conflict = Overlaps(other.Writes, node.Reads | node.Writes) || Overlaps(other.Reads, node.Writes);
+			if (!conflict)
+				continue;
+
+			other.Successors.push_back(later);
+			node.Predecessors.push_back(earlier);
+			node.Level = glm::max(node.Level, other.Level + 1);
+		}
+	}
+}
+
+void TaskGraph::Execute()
+{
+	Build();
+
+	for (unsigned i = 0; i < m_Nodes.size(); i++)
+	{
+		m_Ready[i].Pending.store((int)m_Nodes[i].Predecessors.size(), std::memory_order_relaxed);
+	}
+
+	// Roots Run Now, The Rest Park On Their Predecessors
+	m_FrameStart = std::chrono::steady_clock::now();
+	for (unsigned i = 0; i < m_Nodes.size(); i++)
+	{
+		Job job;
+		job.Function = RunNode;
+		job.Data = this;
+		job.Begin = i;
+		job.End = i + 1;
+		job.Dependency = &m_Ready[i];
+		JobSystem::Run(job, m_Counter);
+	}
+	JobSystem::Wait(m_Counter);
+}
+
+void TaskGraph::RunNode(void* _data, unsigned _begin, unsigned /*_end*/)
+{
+	TaskGraph* graph = static_cast<TaskGraph*>(_data);
+	SystemNode& node = graph->m_Nodes[_begin];
+
+	node.Worker = JobSystem::GetWorkerIndex();
+	node.Start = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - graph->m_FrameStart).count();
+	node.Function();
+	node.End = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - graph->m_FrameStart).count();
+
+	// Successors Whose Last Predecessor This Was Are Released
+	for (unsigned successor : node.Successors)
+	{
+		JobSystem::Signal(graph->m_Ready[successor]);
+	}
+}
+
+bool TaskGraph::WriteTrace(const char* _filePath) const
+{
+	std::ofstream file(_filePath);
+	if (!file.is_open())
+	{
+		Print("Failed To Write Trace");
+		return false;
+	}
+
+	file << "{\"traceEvents\":[\n";
+	for (unsigned i = 0; i < m_Nodes.size(); i++)
+	{
+		const SystemNode& node = m_Nodes[i];
+		file << "{\"name\":\"" << node.Name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << node.Worker
+			<< ",\"ts\":" << node.Start << ",\"dur\":" << node.End - node.Start
+			<< ",\"args\":{\"level\":" << node.Level << "}}" << (i + 1 < m_Nodes.size() ? ",\n" : "\n");
+	}
+	file << "]}\n";
+	return true;
+}
+
+void TaskGraph::PrintSchedule() const
+{
+	for (auto& item : m_Nodes)
+	{
+		std::string dependencies;
+		for (unsigned predecessor : item.Predecessors)
+		{
+			dependencies += dependencies.empty() ? "" : ", ";
+			dependencies += m_Nodes[predecessor].Name;
+		}
+		Print(FrameAllocator::Format("  [%u] %-18s worker %u  %8.1fus - %8.1fus  after : %s",
+			item.Level, item.Name, item.Worker, item.Start, item.End, dependencies.empty() ? "-" : dependencies.c_str()));
+	}
+}
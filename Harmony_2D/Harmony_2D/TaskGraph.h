@@ -0,0 +1,67 @@
+#pragma once
+#include "JobSystem.h"
+#include "FrameAllocator.h"
+#include <chrono>
+
+// Data a system can declare access to. Two systems conflict when one writes what the other
+// reads or writes; conflicting systems run in the order they were added, the rest in parallel.
+enum class Resource : unsigned
+{
+	None = 0,
+	Input = 1 << 0,
+	Camera = 1 << 1,
+	Transforms = 1 << 2,
+	Sprites = 1 << 3,
+	Animations = 1 << 4,
+	PickIDs = 1 << 5,
+	VisibleSprites = 1 << 6,
+	Commands = 1 << 7,
+	Hierarchy = 1 << 8
+};
+
+inline Resource operator|(Resource _a, Resource _b) { return (Resource)((unsigned)_a | (unsigned)_b); }
+inline bool Overlaps(Resource _a, Resource _b) { return ((unsigned)_a & (unsigned)_b) != 0; }
+
+// Per frame DAG of engine systems scheduled on the JobSystem. Systems are registered once,
+// Execute() rebuilds the edges from the declared reads / writes and queues every system as a job
+// that depends on a counter of its unfinished predecessors. The last frame's schedule can be written out as a Chrome trace
+// (chrome://tracing or ui.perfetto.dev).
+class TaskGraph
+{
+public:
+	unsigned AddSystem(const char* _name, Resource _reads, Resource _writes, void (*_function)());
+
+	void Build();
+	void Execute();
+
+	bool WriteTrace(const char* _filePath) const;
+	void PrintSchedule() const;
+
+	inline size_t Size() const { return m_Nodes.size(); }
+
+private:
+	struct SystemNode
+	{
+		const char* Name = nullptr;
+		void (*Function)() = nullptr;
+		Resource Reads = Resource::None;
+		Resource Writes = Resource::None;
+
+		std::vector<unsigned> Successors;
+		std::vector<unsigned> Predecessors;
+		unsigned Level = 0;
+
+		// Last Execute
+		unsigned Worker = 0;
+		double Start = 0.0;
+		double End = 0.0;
+	};
+
+	static void RunNode(void* _data, unsigned _begin, unsigned _end);
+
+	std::vector<SystemNode> m_Nodes;
+	// Predecessors still running this frame, each node's job depends on its counter
+	std::vector<JobCounter> m_Ready;
+	JobCounter m_Counter;
+	std::chrono::steady_clock::time_point m_FrameStart;
+};
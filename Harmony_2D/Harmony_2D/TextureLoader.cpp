@@ -1,4 +1,6 @@
 #include "TextureLoader.h"
+#include "FrameAllocator.h"
+#include <cstring>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <STBI/stb_image.h>
@@ -9,6 +11,10 @@ TextureLoader::~TextureLoader()
     {
         glDeleteTextures(1, &item.ID);
     }
+    for (auto& item : m_TextureArrays)
+    {
+        glDeleteTextures(1, &item.ID);
+    }
 }
 
 void TextureLoader::Init()
@@ -53,3 +59,106 @@ Texture TextureLoader::LoadTexture(const char* _filePath)
 
     return m_Textures.back();
 }
+
+TextureLayer TextureLoader::LoadTextureLayer(const char* _filePath)
+{
+    for (auto& item : m_TextureLayers)
+    {
+        if (item.FilePath == _filePath)
+        {
+            return item;
+        }
+    }
+
+    // Arrays are always RGBA8
+    GLint width, height, components;
+    GLubyte* imageData = stbi_load(_filePath, &width, &height, &components, 4);
+    if (!imageData)
+    {
+        Print(FrameAllocator::Format("Failed to load %s", _filePath));
+        return {};
+    }
+
+    // Size Class
+    GLsizei classWidth = 32, classHeight = 32;
+    while (classWidth < width)
+        classWidth *= 2;
+    while (classHeight < height)
+        classHeight *= 2;
+
+    TextureArray& array = FindArray(classWidth, classHeight);
+    GLsizei layer = array.Layers++;
+
+    // Image Bottom Left, Padding Repeats The Edge Texels So Filtering And Lower Mips Only See The Image
+    std::vector<GLubyte> pixels((size_t)classWidth * classHeight * 4);
+    for (GLsizei y = 0; y < classHeight; y++)
+    {
+        const GLubyte* row = imageData + (size_t)glm::min(y, height - 1) * width * 4;
+        for (GLsizei x = 0; x < classWidth; x++)
+            std::memcpy(&pixels[((size_t)y * classWidth + x) * 4], row + (size_t)glm::min(x, width - 1) * 4, 4);
+    }
+    stbi_image_free(imageData);
+    imageData = nullptr;
+
+    // Box Filter This Layer's Mips, glGenerateTextureMipmap Would Redo Every Layer Of The Array
+    GLsizei levelWidth = classWidth, levelHeight = classHeight;
+    glTextureSubImage3D(array.ID, 0, 0, 0, layer, levelWidth, levelHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    for (GLint level = 1; levelWidth > 1 || levelHeight > 1; level++)
+    {
+        GLsizei nextWidth = glm::max(levelWidth / 2, 1), nextHeight = glm::max(levelHeight / 2, 1);
+        for (GLsizei y = 0; y < nextHeight; y++)
+        {
+            const GLubyte* row0 = &pixels[(size_t)glm::min(y * 2, levelHeight - 1) * levelWidth * 4];
+            const GLubyte* row1 = &pixels[(size_t)glm::min(y * 2 + 1, levelHeight - 1) * levelWidth * 4];
+            for (GLsizei x = 0; x < nextWidth; x++)
+            {
+                size_t x0 = (size_t)glm::min(x * 2, levelWidth - 1) * 4, x1 = (size_t)glm::min(x * 2 + 1, levelWidth - 1) * 4;
+                for (int c = 0; c < 4; c++)
+                    pixels[((size_t)y * nextWidth + x) * 4 + c] = (GLubyte)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+            }
+        }
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+        glTextureSubImage3D(array.ID, level, 0, 0, layer, levelWidth, levelHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+
+    m_TextureLayers.emplace_back(TextureLayer{ array.ID, (GLuint)layer, { (float)width / classWidth, (float)height / classHeight }, { width, height }, _filePath });
+
+    return m_TextureLayers.back();
+}
+
+TextureLoader::TextureArray& TextureLoader::FindArray(GLsizei _width, GLsizei _height)
+{
+    for (auto& item : m_TextureArrays)
+    {
+        if (item.Width == _width && item.Height == _height && item.Layers < item.Capacity)
+        {
+            return item;
+        }
+    }
+
+    // New Array Sized To The Budget
+    TextureArray array;
+    array.Width = _width;
+    array.Height = _height;
+    array.Capacity = (GLsizei)glm::clamp(ArrayBudgetBytes / ((size_t)_width * _height * 4), (size_t)1, (size_t)MaxArrayLayers);
+
+    GLsizei levels = 1;
+    while ((glm::max(_width, _height) >> levels) > 0)
+        levels++;
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array.ID);
+    glTextureStorage3D(array.ID, levels, GL_RGBA8, _width, _height, array.Capacity);
+
+    glTextureParameteri(array.ID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(array.ID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Clamp, Repeat Would Pull In The Padding
+    glTextureParameteri(array.ID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(array.ID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    Print(FrameAllocator::Format("Texture Array %u : %dx%d, %d layers", array.ID, _width, _height, array.Capacity));
+
+    m_TextureArrays.push_back(array);
+    return m_TextureArrays.back();
+}
@@ -6,7 +6,27 @@ public:
 	~TextureLoader();
 	static void Init();
 	static Texture LoadTexture(const char* _filePath);
+	// Loads the image into a layer of a texture array shared with every image of the same size class
+	// (each side rounded up to a power of two), so sprites using them batch under one bind
+	static TextureLayer LoadTextureLayer(const char* _filePath);
 
 	inline static std::vector<Texture> m_Textures;
+	inline static std::vector<TextureLayer> m_TextureLayers;
+
+	// Layers per array are capped by the 7 bits sprites carry and by ArrayBudgetBytes
+	static const GLsizei MaxArrayLayers = 128;
+	static const size_t ArrayBudgetBytes = 16 * 1024 * 1024;
+private:
+	struct TextureArray
+	{
+		GLuint ID = 0;
+		GLsizei Width = 0;
+		GLsizei Height = 0;
+		GLsizei Layers = 0;
+		GLsizei Capacity = 0;
+	};
+	static TextureArray& FindArray(GLsizei _width, GLsizei _height);
+
+	inline static std::vector<TextureArray> m_TextureArrays;
 };
 
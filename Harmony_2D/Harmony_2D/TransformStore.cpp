@@ -0,0 +1,261 @@
+#include "TransformStore.h"
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	// Cody-Waite split of pi/2 and the minimax sin / cos polynomials on [-pi/4, pi/4]
+	const float PiOver2Hi = 1.5703125f;
+	const float PiOver2Mid = 4.837512969970703125e-4f;
+	const float PiOver2Lo = 7.54978995489188216e-8f;
+	const float TwoOverPi = 0.636619772367581343f;
+
+	const float Sin1 = -1.6666654611e-1f;
+	const float Sin2 = 8.3321608736e-3f;
+	const float Sin3 = -1.9515295891e-4f;
+	const float Cos1 = 4.166664568298827e-2f;
+	const float Cos2 = -1.388731625493765e-3f;
+	const float Cos3 = 2.443315711809948e-5f;
+
+#if defined(__AVX2__)
+	// 8 sprites per iteration
+	inline size_t UpdateAVX2(TransformStore& _store, size_t _begin, size_t _end)
+	{
+		const __m256 twoOverPi = _mm256_set1_ps(TwoOverPi);
+		const __m256 pio2Hi = _mm256_set1_ps(PiOver2Hi);
+		const __m256 pio2Mid = _mm256_set1_ps(PiOver2Mid);
+		const __m256 pio2Lo = _mm256_set1_ps(PiOver2Lo);
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		const __m256i one = _mm256_set1_epi32(1);
+		const __m256i two = _mm256_set1_epi32(2);
+
+		size_t i = _begin;
+		for (; i + 8 <= _end; i += 8)
+		{
+			__m256 angle = _mm256_loadu_ps(&_store.m_Rotation[i]);
+
+			// Range Reduce To Quadrant
+			__m256 quadrantF = _mm256_round_ps(_mm256_mul_ps(angle, twoOverPi), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+			__m256i quadrant = _mm256_cvtps_epi32(quadrantF);
+			__m256 r = _mm256_sub_ps(angle, _mm256_mul_ps(quadrantF, pio2Hi));
+			r = _mm256_sub_ps(r, _mm256_mul_ps(quadrantF, pio2Mid));
+			r = _mm256_sub_ps(r, _mm256_mul_ps(quadrantF, pio2Lo));
+			__m256 r2 = _mm256_mul_ps(r, r);
+
+			// Polynomials
+			__m256 sinR = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Sin3), r2), _mm256_set1_ps(Sin2));
+			sinR = _mm256_add_ps(_mm256_mul_ps(sinR, r2), _mm256_set1_ps(Sin1));
+			sinR = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinR, r2), r), r);
+
+			__m256 cosR = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Cos3), r2), _mm256_set1_ps(Cos2));
+			cosR = _mm256_add_ps(_mm256_mul_ps(cosR, r2), _mm256_set1_ps(Cos1));
+			cosR = _mm256_mul_ps(_mm256_mul_ps(cosR, r2), r2);
+			cosR = _mm256_add_ps(_mm256_sub_ps(cosR, _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), _mm256_set1_ps(1.0f));
+
+			// Swap For Odd Quadrants, Negate By Quadrant
+			__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+			__m256 sine = _mm256_blendv_ps(sinR, cosR, swap);
+			__m256 cosine = _mm256_blendv_ps(cosR, sinR, swap);
+			__m256 sinFlip = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+			__m256 cosFlip = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+			sine = _mm256_xor_ps(sine, sinFlip);
+			cosine = _mm256_xor_ps(cosine, cosFlip);
+
+			// Scale
+			__m256 scaleX = _mm256_loadu_ps(&_store.m_ScaleX[i]);
+			__m256 scaleY = _mm256_loadu_ps(&_store.m_ScaleY[i]);
+			_mm256_storeu_ps(&_store.m_A[i], _mm256_mul_ps(cosine, scaleX));
+			_mm256_storeu_ps(&_store.m_B[i], _mm256_mul_ps(sine, scaleX));
+			_mm256_storeu_ps(&_store.m_C[i], _mm256_xor_ps(_mm256_mul_ps(sine, scaleY), signMask));
+			_mm256_storeu_ps(&_store.m_D[i], _mm256_mul_ps(cosine, scaleY));
+		}
+		return i;
+	}
+#elif defined(_M_X64) || defined(__SSE2__)
+	// 4 sprites per iteration
+	inline size_t UpdateSSE2(TransformStore& _store, size_t _begin, size_t _end)
+	{
+		const __m128 twoOverPi = _mm_set1_ps(TwoOverPi);
+		const __m128 pio2Hi = _mm_set1_ps(PiOver2Hi);
+		const __m128 pio2Mid = _mm_set1_ps(PiOver2Mid);
+		const __m128 pio2Lo = _mm_set1_ps(PiOver2Lo);
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i two = _mm_set1_epi32(2);
+
+		size_t i = _begin;
+		for (; i + 4 <= _end; i += 4)
+		{
+			__m128 angle = _mm_loadu_ps(&_store.m_Rotation[i]);
+
+			// Range Reduce To Quadrant (cvtps rounds to nearest under the default MXCSR)
+			__m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, twoOverPi));
+			__m128 quadrantF = _mm_cvtepi32_ps(quadrant);
+			__m128 r = _mm_sub_ps(angle, _mm_mul_ps(quadrantF, pio2Hi));
+			r = _mm_sub_ps(r, _mm_mul_ps(quadrantF, pio2Mid));
+			r = _mm_sub_ps(r, _mm_mul_ps(quadrantF, pio2Lo));
+			__m128 r2 = _mm_mul_ps(r, r);
+
+			// Polynomials
+			__m128 sinR = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Sin3), r2), _mm_set1_ps(Sin2));
+			sinR = _mm_add_ps(_mm_mul_ps(sinR, r2), _mm_set1_ps(Sin1));
+			sinR = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinR, r2), r), r);
+
+			__m128 cosR = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Cos3), r2), _mm_set1_ps(Cos2));
+			cosR = _mm_add_ps(_mm_mul_ps(cosR, r2), _mm_set1_ps(Cos1));
+			cosR = _mm_mul_ps(_mm_mul_ps(cosR, r2), r2);
+			cosR = _mm_add_ps(_mm_sub_ps(cosR, _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_set1_ps(1.0f));
+
+			// Swap For Odd Quadrants, Negate By Quadrant
+			__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+			__m128 sine = _mm_or_ps(_mm_and_ps(swap, cosR), _mm_andnot_ps(swap, sinR));
+			__m128 cosine = _mm_or_ps(_mm_and_ps(swap, sinR), _mm_andnot_ps(swap, cosR));
+			__m128 sinFlip = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+			__m128 cosFlip = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+			sine = _mm_xor_ps(sine, sinFlip);
+			cosine = _mm_xor_ps(cosine, cosFlip);
+
+			// Scale
+			__m128 scaleX = _mm_loadu_ps(&_store.m_ScaleX[i]);
+			__m128 scaleY = _mm_loadu_ps(&_store.m_ScaleY[i]);
+			_mm_storeu_ps(&_store.m_A[i], _mm_mul_ps(cosine, scaleX));
+			_mm_storeu_ps(&_store.m_B[i], _mm_mul_ps(sine, scaleX));
+			_mm_storeu_ps(&_store.m_C[i], _mm_xor_ps(_mm_mul_ps(sine, scaleY), signMask));
+			_mm_storeu_ps(&_store.m_D[i], _mm_mul_ps(cosine, scaleY));
+		}
+		return i;
+	}
+#endif
+}
+
+unsigned TransformStore::Add(double _x, double _y, float _rotation, float _scaleX, float _scaleY, float _layer)
+{
+	m_WorldX.push_back(_x);
+	m_WorldY.push_back(_y);
+	m_X.push_back((float)(_x - m_Origin.x));
+	m_Y.push_back((float)(_y - m_Origin.y));
+	m_Rotation.push_back(_rotation);
+	m_ScaleX.push_back(_scaleX);
+	m_ScaleY.push_back(_scaleY);
+	m_Layer.push_back(_layer);
+
+	m_A.push_back(_scaleX);
+	m_B.push_back(0.0f);
+	m_C.push_back(0.0f);
+	m_D.push_back(_scaleY);
+
+	MarkDirty(m_X.size() - 1);
+	return (unsigned)m_X.size() - 1;
+}
+
+void TransformStore::Reserve(size_t _count)
+{
+	m_WorldX.reserve(_count);
+	m_WorldY.reserve(_count);
+	for (auto* item : { &m_X, &m_Y, &m_Rotation, &m_ScaleX, &m_ScaleY, &m_Layer, &m_A, &m_B, &m_C, &m_D })
+	{
+		item->reserve(_count);
+	}
+}
+
+void TransformStore::Clear()
+{
+	ClearDirty();
+	m_WorldX.clear();
+	m_WorldY.clear();
+	for (auto* item : { &m_X, &m_Y, &m_Rotation, &m_ScaleX, &m_ScaleY, &m_Layer, &m_A, &m_B, &m_C, &m_D })
+	{
+		item->clear();
+	}
+}
+
+void TransformStore::Update()
+{
+	Update(0, Size());
+}
+
+void TransformStore::Update(size_t _begin, size_t _end)
+{
+	size_t tail = _begin;
+#if defined(__AVX2__)
+	tail = UpdateAVX2(*this, _begin, _end);
+#elif defined(_M_X64) || defined(__SSE2__)
+	tail = UpdateSSE2(*this, _begin, _end);
+#endif
+	UpdateScalar(tail, _end);
+}
+
+void TransformStore::UpdateScalar(size_t _begin, size_t _end)
+{
+	for (size_t i = _begin; i < _end; i++)
+	{
+		float sine = std::sin(m_Rotation[i]);
+		float cosine = std::cos(m_Rotation[i]);
+		m_A[i] = cosine * m_ScaleX[i];
+		m_B[i] = sine * m_ScaleX[i];
+		m_C[i] = -sine * m_ScaleY[i];
+		m_D[i] = cosine * m_ScaleY[i];
+	}
+}
+
+void TransformStore::SetPosition(size_t _index, double _x, double _y)
+{
+	m_WorldX[_index] = _x;
+	m_WorldY[_index] = _y;
+	m_X[_index] = (float)(_x - m_Origin.x);
+	m_Y[_index] = (float)(_y - m_Origin.y);
+	MarkDirty(_index);
+}
+
+void TransformStore::Rebase(const glm::dvec2& _origin)
+{
+	// Recompute From World Positions So Repeated Rebases Never Accumulate Float Error
+	m_Origin = _origin;
+	for (size_t i = 0; i < m_X.size(); i++)
+	{
+		m_X[i] = (float)(m_WorldX[i] - _origin.x);
+		m_Y[i] = (float)(m_WorldY[i] - _origin.y);
+	}
+	MarkDirty(0, Size());
+}
+
+void TransformStore::MarkDirty(size_t _index)
+{
+	size_t page = _index / DirtyPageSize;
+	if (page / 64 >= m_DirtyPages.size())
+		m_DirtyPages.resize(page / 64 + 1, 0);
+
+	uint64_t bit = (uint64_t)1 << (page % 64);
+	if ((m_DirtyPages[page / 64] & bit) == 0)
+	{
+		m_DirtyPages[page / 64] |= bit;
+		m_DirtyCount++;
+	}
+}
+
+void TransformStore::MarkDirty(size_t _begin, size_t _end)
+{
+	for (size_t page = _begin / DirtyPageSize; page * DirtyPageSize < _end; page++)
+	{
+		MarkDirty(page * DirtyPageSize);
+	}
+}
+
+void TransformStore::ClearDirty()
+{
+	std::fill(m_DirtyPages.begin(), m_DirtyPages.end(), 0);
+	m_DirtyCount = 0;
+}
+
+Affine2D TransformStore::GetMatrix(size_t _index) const
+{
+	return { m_A[_index], m_B[_index], m_C[_index], m_D[_index], m_X[_index], m_Y[_index] };
+}
+
+glm::mat4 TransformStore::GetModelMatrix(size_t _index) const
+{
+	return AffineToModelMatrix(GetMatrix(_index), m_Layer[_index]);
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "Helper.h"
+#include <bit>
+
+// Structure of arrays transform storage for large sprite counts.
+// World positions are kept in double, m_X / m_Y are floats relative to the camera's floating origin
+// (see Camera::RebaseOrigin), Update() expands the inputs into the linear part of a 2x3 affine matrix per sprite.
+// Changed transforms are tracked in pages of DirtyPageSize, anything that writes the inputs directly calls MarkDirty.
+// The dirty pages stay set until the renderer has consumed them and calls ClearDirty.
+class TransformStore
+{
+public:
+	unsigned Add(double _x, double _y, float _rotation = 0.0f, float _scaleX = 1.0f, float _scaleY = 1.0f, float _layer = 0.0f);
+	void Reserve(size_t _count);
+	void Clear();
+
+	void Update();
+	void Update(size_t _begin, size_t _end);
+	void UpdateScalar(size_t _begin, size_t _end);
+
+	void SetPosition(size_t _index, double _x, double _y);
+	void Rebase(const glm::dvec2& _origin);
+	inline const glm::dvec2& GetOrigin() const { return m_Origin; }
+
+	void MarkDirty(size_t _index);
+	void MarkDirty(size_t _begin, size_t _end);
+	void ClearDirty();
+	inline bool IsDirty() const { return m_DirtyCount > 0; }
+
+	// Calls _function(begin, end) for each run of consecutive dirty pages, clamped to Size()
+	template <typename F>
+	void ForEachDirtyRange(F&& _function) const
+	{
+		size_t pages = (Size() + DirtyPageSize - 1) / DirtyPageSize;
+		size_t page = 0;
+		while (page < pages)
+		{
+			// Skip Clean Words
+			uint64_t word = m_DirtyPages[page / 64] >> (page % 64);
+			if (word == 0)
+			{
+				page = (page / 64 + 1) * 64;
+				continue;
+			}
+			page += std::countr_zero(word);
+			if (page >= pages)
+				break;
+
+			size_t end = page;
+			while (end < pages && (m_DirtyPages[end / 64] >> (end % 64) & 1))
+				end++;
+			_function(page * DirtyPageSize, glm::min(end * DirtyPageSize, Size()));
+			page = end;
+		}
+	}
+
+	Affine2D GetMatrix(size_t _index) const;
+	glm::mat4 GetModelMatrix(size_t _index) const;
+
+	inline size_t Size() const { return m_X.size(); }
+
+	// Inputs
+	std::vector<double> m_WorldX;
+	std::vector<double> m_WorldY;
+	std::vector<float> m_X;
+	std::vector<float> m_Y;
+	std::vector<float> m_Rotation;
+	std::vector<float> m_ScaleX;
+	std::vector<float> m_ScaleY;
+	std::vector<float> m_Layer;
+
+	// Outputs : linear part of the affine matrix, translation is m_X / m_Y
+	std::vector<float> m_A;
+	std::vector<float> m_B;
+	std::vector<float> m_C;
+	std::vector<float> m_D;
+
+	inline static const size_t DirtyPageSize = 64;
+
+private:
+	glm::dvec2 m_Origin{ 0.0 };
+
+	// One bit per page
+	std::vector<uint64_t> m_DirtyPages;
+	size_t m_DirtyCount = 0;
+};
@@ -0,0 +1,63 @@
+#include "VertexLayout.h"
+
+struct FormatInfo
+{
+	GLint Components;
+	GLenum Type;
+	GLboolean Normalized;
+	bool Integer;
+	unsigned Size;
+};
+
+static FormatInfo GetFormatInfo(AttributeFormat _format)
+{
+	switch (_format)
+	{
+	case AttributeFormat::Float2:
+		return { 2, GL_FLOAT, GL_FALSE, false, 8 };
+	case AttributeFormat::Float3:
+		return { 3, GL_FLOAT, GL_FALSE, false, 12 };
+	case AttributeFormat::Float4:
+		return { 4, GL_FLOAT, GL_FALSE, false, 16 };
+	case AttributeFormat::Snorm16x2:
+		return { 2, GL_SHORT, GL_TRUE, false, 4 };
+	case AttributeFormat::Unorm16x2:
+		return { 2, GL_UNSIGNED_SHORT, GL_TRUE, false, 4 };
+	case AttributeFormat::Unorm8x4:
+		return { 4, GL_UNSIGNED_BYTE, GL_TRUE, false, 4 };
+	case AttributeFormat::Uint32:
+		return { 1, GL_UNSIGNED_INT, GL_FALSE, true, 4 };
+	case AttributeFormat::Int32:
+		return { 1, GL_INT, GL_FALSE, true, 4 };
+	default:
+		return { 0, GL_FLOAT, GL_FALSE, false, 0 };
+	}
+}
+
+VertexLayout& VertexLayout::Add(GLuint _location, AttributeFormat _format, unsigned _offset)
+{
+	m_Attributes.push_back({ _location, _format, _offset });
+	return *this;
+}
+
+void VertexLayout::Apply(GLuint _vertexArray, GLuint _vertexBuffer, GLuint _binding) const
+{
+	for (auto& item : m_Attributes)
+	{
+		FormatInfo info = GetFormatInfo(item.Format);
+		glEnableVertexArrayAttrib(_vertexArray, item.Location);
+		if (info.Integer)
+			glVertexArrayAttribIFormat(_vertexArray, item.Location, info.Components, info.Type, item.Offset);
+		else
+			glVertexArrayAttribFormat(_vertexArray, item.Location, info.Components, info.Type, info.Normalized, item.Offset);
+		glVertexArrayAttribBinding(_vertexArray, item.Location, _binding);
+	}
+
+	if (_vertexBuffer != 0)
+		glVertexArrayVertexBuffer(_vertexArray, _binding, _vertexBuffer, 0, m_Stride);
+}
+
+unsigned VertexLayout::GetFormatSize(AttributeFormat _format)
+{
+	return GetFormatInfo(_format).Size;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Helper.h"
+
+enum class AttributeFormat : unsigned char
+{
+	Float2,
+	Float3,
+	Float4,
+	Snorm16x2,
+	Unorm16x2,
+	Unorm8x4,
+	Uint32,
+	Int32
+};
+
+struct VertexAttribute
+{
+	GLuint Location;
+	AttributeFormat Format;
+	unsigned Offset;
+};
+
+// Describes one interleaved vertex buffer binding. Apply() turns the description into the
+// vertex array's attribute formats, so packed formats need no hand written glVertexAttrib calls.
+class VertexLayout
+{
+public:
+	VertexLayout(unsigned _stride) : m_Stride(_stride) {}
+
+	VertexLayout& Add(GLuint _location, AttributeFormat _format, unsigned _offset);
+	void Apply(GLuint _vertexArray, GLuint _vertexBuffer = 0, GLuint _binding = 0) const;
+
+	inline unsigned GetStride() const { return m_Stride; }
+	inline const std::vector<VertexAttribute>& GetAttributes() const { return m_Attributes; }
+
+	static unsigned GetFormatSize(AttributeFormat _format);
+
+private:
+	std::vector<VertexAttribute> m_Attributes;
+	unsigned m_Stride = 0;
+};